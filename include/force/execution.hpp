@@ -0,0 +1,202 @@
+///
+/// \file      execution.hpp
+/// \brief     Shared thread pool, execution policies and helpers to split 2D work into row bands.
+/// \details
+///
+/// Parallel algorithms don't start threads, they hand bands to a thread_pool that lives for the whole
+/// program (default_thread_pool) or to one passed through execution::par.on(pool). The thread that
+/// calls in always runs band 0 and, while waiting for the rest, runs queued bands itself, so nested
+/// parallel calls can't deadlock the pool.
+///
+/// \author    HenryDu
+/// \date      18.10.2026
+/// \copyright © HenryDu 2026. All right reserved.
+///
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace force {
+    namespace detail {
+        inline std::size_t hardware_workers() {
+            auto n = std::thread::hardware_concurrency();
+            return n == 0 ? 1 : static_cast<std::size_t>(n);
+        }
+    }
+    ///
+    /// \class   thread_pool
+    /// \brief   Fixed set of workers running fork-join batches.
+    /// \details The caller of parallel_for takes part in its own batch, a pool of n workers runs n + 1 tasks at once.
+    ///
+    class thread_pool {
+    public:
+        explicit thread_pool(std::size_t workers = detail::hardware_workers() - 1) {
+            mWorkers.reserve(workers);
+            for (std::size_t i = 0; i != workers; ++i) {
+                mWorkers.emplace_back([this](std::stop_token token) { work(token); });
+            }
+        }
+        thread_pool(const thread_pool&)            = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        // Threads that can run tasks at the same time, the calling thread included.
+        std::size_t concurrency() const { return mWorkers.size() + 1; }
+
+        /// \brief  Run f(i) for every i in [0, count) and return once all are done. The first exception thrown by
+        ///         any f is rethrown here after the whole batch finished.
+        template <typename Fn>
+        void parallel_for(const std::size_t count, Fn f) {
+            if (count == 0) return;
+            if (count == 1 || mWorkers.empty()) {
+                for (std::size_t i = 0; i != count; ++i) { std::invoke(f, i); }
+                return;
+            }
+            // Batch state lives on this stack frame, it is only touched under mLock so the last task can't
+            // still be using it once this returns.
+            std::size_t        remaining = count - 1;
+            std::exception_ptr error;
+            auto guarded = [&](std::size_t i) {
+                try { std::invoke(f, i); }
+                catch (...) {
+                    std::scoped_lock lock(mLock);
+                    if (!error) error = std::current_exception();
+                }
+            };
+            {
+                std::scoped_lock lock(mLock);
+                for (std::size_t i = 1; i != count; ++i) {
+                    mTasks.emplace_back([this, &guarded, &remaining, i] {
+                        guarded(i);
+                        std::scoped_lock lock(mLock);
+                        --remaining;
+                        mDone.notify_all();
+                    });
+                }
+            }
+            mReady.notify_all();
+            mDone.notify_all();
+            guarded(0);
+            // Help with whatever is queued (ours or a nested batch's) instead of sleeping.
+            std::unique_lock lock(mLock);
+            while (remaining != 0) {
+                if (mTasks.empty()) { mDone.wait(lock); continue; }
+                auto task = std::move(mTasks.front());
+                mTasks.pop_front();
+                lock.unlock();
+                task();
+                lock.lock();
+            }
+            if (error) std::rethrow_exception(error);
+        }
+
+        ~thread_pool() {
+            for (auto& w : mWorkers) { w.request_stop(); }
+            mReady.notify_all();
+        }
+    private:
+        void work(std::stop_token token) {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock(mLock);
+                    if (!mReady.wait(lock, token, [this] { return !mTasks.empty(); })) return;
+                    task = std::move(mTasks.front());
+                    mTasks.pop_front();
+                }
+                task();
+            }
+        }
+
+        std::mutex                        mLock;
+        std::condition_variable_any       mReady;   // Workers wait here for tasks.
+        std::condition_variable_any       mDone;    // Callers wait here for their batch (or for tasks to help with).
+        std::deque<std::function<void()>> mTasks;
+        std::vector<std::jthread>         mWorkers;
+    };
+    // Pool shared by every parallel algorithm that isn't given one, created on first use.
+    inline thread_pool& default_thread_pool() {
+        static thread_pool pool;
+        return pool;
+    }
+
+    namespace execution {
+        // Tags that pick the serial or the multithreaded overload of an algorithm.
+        struct sequenced_policy {};
+        struct parallel_policy  {
+            thread_pool* pool = nullptr;
+            // Same policy running on the given pool instead of the default one.
+            constexpr parallel_policy on(thread_pool& p) const { return parallel_policy{ &p }; }
+            thread_pool&              executor()         const { return pool == nullptr ? default_thread_pool() : *pool; }
+        };
+        inline constexpr sequenced_policy seq{};
+        inline constexpr parallel_policy  par{};
+    }
+    template <typename Ty>
+    concept execution_policy_concept = std::is_same_v<std::remove_cvref_t<Ty>, execution::sequenced_policy> ||
+                                       std::is_same_v<std::remove_cvref_t<Ty>, execution::parallel_policy>;
+
+    namespace detail {
+        // Below this many elements per band a parallel overload keeps the work on the calling thread.
+        constexpr std::size_t parallel_min_elements = 1 << 15;
+        constexpr std::size_t cache_line_bytes      = 64;
+
+        // Data cache sizes in bytes, queried once. Falls back to common desktop sizes where they can't be queried.
+        struct cache_info {
+            std::size_t l1 = 32 * 1024;
+            std::size_t l2 = 256 * 1024;
+        };
+        inline const cache_info& cache_sizes() {
+            static const cache_info info = [] {
+                cache_info c;
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE)
+                if (auto l1 = ::sysconf(_SC_LEVEL1_DCACHE_SIZE); l1 > 0) { c.l1 = static_cast<std::size_t>(l1); }
+                if (auto l2 = ::sysconf(_SC_LEVEL2_CACHE_SIZE);  l2 > 0) { c.l2 = static_cast<std::size_t>(l2); }
+#endif
+                return c;
+            }();
+            return info;
+        }
+        /// \brief  How many bands [0, count) should be cut into so that every band has at least min_grain items.
+        inline std::size_t band_count(const std::size_t count, const std::size_t min_grain, const thread_pool& pool = default_thread_pool()) {
+            auto grain = min_grain == 0 ? 1 : min_grain;
+            return std::clamp<std::size_t>(count / grain, 1, pool.concurrency());
+        }
+        /// \brief  Rows per step so that band edges start on a new cache line, for rows row_bytes apart
+        ///         (assuming the first row is line aligned).
+        inline std::size_t band_alignment(const std::ptrdiff_t row_bytes) {
+            auto bytes = static_cast<std::size_t>(row_bytes < 0 ? -row_bytes : row_bytes);
+            return bytes == 0 ? 1 : cache_line_bytes / std::gcd(bytes, cache_line_bytes);
+        }
+        /// \brief  Run f(band, begin, end) on bands contiguous ranges splitting [0, count), every inner edge is a
+        ///         multiple of align. The calling thread takes band 0 so one band never touches the pool.
+        template <typename Fn>
+        void for_each_band(thread_pool& pool, const std::size_t count, const std::size_t bands, const std::size_t align, Fn f) {
+            auto a = std::max<std::size_t>(1, align);
+            auto n = std::max<std::size_t>(1, std::min(bands, (count + a - 1) / a));
+            auto edge = [count, n, a](std::size_t b) {
+                return b == n ? count : std::min(count, (count * b / n + a / 2) / a * a);
+            };
+            pool.parallel_for(n, [&f, &edge](std::size_t b) {
+                auto beg = edge(b), end = edge(b + 1);
+                if (beg < end) std::invoke(f, b, beg, end);
+            });
+        }
+        template <typename Fn>
+        void for_each_band(const std::size_t count, const std::size_t bands, Fn f) {
+            for_each_band(default_thread_pool(), count, bands, 1, f);
+        }
+    }
+}
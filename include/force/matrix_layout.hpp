@@ -0,0 +1,325 @@
+///
+/// \file      matrix_layout.hpp
+/// \brief     Block-linear and Z-order (Morton) 2D layouts next to row-major matrix_view.
+/// \details
+///
+/// matrix_view describes strided row-major memory, so stepping one row down always jumps row_delta
+/// elements. The views here store the same w x h grid in an order where 2D neighbours are also close
+/// in memory:
+///
+/// - tiled_matrix_view keeps tile_w x tile_h blocks contiguous (row-major inside a tile, tiles in
+///   row-major order). Edge tiles are padded to full size, so every tile is a plain matrix_view.
+/// - morton_matrix_view interleaves the bits of x and y. The grid is cut into square power-of-two
+///   blocks (the side being the smaller extent rounded up) placed one after another along the longer
+///   axis, and every block is in Z-order.
+///
+/// Both are non-owning like matrix_view, storage_size() tells how many elements a buffer must hold.
+/// Indices are computed with shifts, masks and magic-bit spreading rather than BMI2 PDEP/PEXT, which
+/// is slow on older AMD parts and is not available off x86.
+///
+/// for_each_view and copy_view take these views and visit elements in storage order, padding is
+/// skipped. copy_view_layout converts between a layout and row-major.
+///
+/// \author    HenryDu
+/// \date      18.10.2026
+/// \copyright © HenryDu 2026. All right reserved.
+///
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+#include "force/matrix_view.hpp"
+
+namespace force {
+    namespace detail {
+        // Inverse of spread_bits, keep every even bit and pack them: 0a0b0c0d -> abcd.
+        constexpr std::uint32_t compact_bits(std::uint64_t x) {
+            x &= 0x5555555555555555ULL;
+            x = (x | (x >> 1))  & 0x3333333333333333ULL;
+            x = (x | (x >> 2))  & 0x0F0F0F0F0F0F0F0FULL;
+            x = (x | (x >> 4))  & 0x00FF00FF00FF00FFULL;
+            x = (x | (x >> 8))  & 0x0000FFFF0000FFFFULL;
+            x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+            return static_cast<std::uint32_t>(x);
+        }
+        constexpr std::pair<std::uint32_t, std::uint32_t> morton_decode(const std::uint64_t i) { return { compact_bits(i), compact_bits(i >> 1) }; }
+
+        // Call f(element, x, y) or f(element) depending on what f accepts.
+        template <typename F, typename Ty>
+        constexpr void invoke_layout(F& f, Ty& v, const std::size_t x, const std::size_t y) {
+            if constexpr (std::is_invocable_v<F&, Ty&, std::size_t, std::size_t>) {
+                std::invoke(f, v, x, y);
+            }
+            else {
+                std::invoke(f, v);
+            }
+        }
+
+        constexpr std::uint32_t layout_shift(const std::size_t extent) {
+            if (!std::has_single_bit(extent)) throw std::runtime_error("Tile extent must be a power of two!");
+            return static_cast<std::uint32_t>(std::countr_zero(extent));
+        }
+    }
+
+    ///
+    /// \class   tiled_matrix_view
+    /// \brief   w x h elements stored as contiguous tile_w x tile_h tiles, tile extents are powers of two.
+    /// \details Element (x, y) lives in tile (x / tile_w, y / tile_h) at row y % tile_h, column x % tile_w.
+    /// \tparam  Ty - Element type.
+    ///
+    template <typename Ty>
+    class tiled_matrix_view {
+    public:
+        using value_type      = Ty;
+        using reference       = value_type&;
+        using const_reference = const value_type&;
+        using pointer         = value_type*;
+        using const_pointer   = const value_type*;
+        using point_type      = typename matrix_view<Ty>::point_type;
+
+        constexpr tiled_matrix_view() = default;
+        /// \param p      - Pointer to at least storage_size(w, h, tile_w, tile_h) elements.
+        /// \param w      - width
+        /// \param h      - height
+        /// \param tile_w - Tile width, power of two.
+        /// \param tile_h - Tile height, power of two.
+        constexpr tiled_matrix_view(const_pointer p, const std::size_t w, const std::size_t h, const std::size_t tile_w, const std::size_t tile_h)
+            : mPtr(const_cast<pointer>(p)), mWidth(w), mHeight(h), mShiftX(detail::layout_shift(tile_w)), mShiftY(detail::layout_shift(tile_h)),
+              mTilesX((w + tile_w - 1) >> mShiftX) {}
+
+        static constexpr std::size_t storage_size(const std::size_t w, const std::size_t h, const std::size_t tile_w, const std::size_t tile_h) {
+            return ((w + tile_w - 1) / tile_w) * ((h + tile_h - 1) / tile_h) * tile_w * tile_h;
+        }
+
+        constexpr std::size_t   width()       const { return mWidth; }
+        constexpr std::size_t   height()      const { return mHeight; }
+        constexpr std::size_t   size()        const { return mWidth * mHeight; }
+        constexpr std::size_t   tile_width()  const { return std::size_t(1) << mShiftX; }
+        constexpr std::size_t   tile_height() const { return std::size_t(1) << mShiftY; }
+        constexpr std::size_t   tiles_x()     const { return mTilesX; }
+        constexpr std::size_t   tiles_y()     const { return (mHeight + tile_height() - 1) >> mShiftY; }
+        constexpr std::size_t   storage_size() const { return storage_size(mWidth, mHeight, tile_width(), tile_height()); }
+        constexpr pointer       data()              { return mPtr; }
+        constexpr const_pointer data()        const { return mPtr; }
+
+        /// \brief  Storage offset of element (x, y).
+        constexpr std::size_t index(const std::size_t x, const std::size_t y) const {
+            const auto tile = ((y >> mShiftY) * mTilesX + (x >> mShiftX)) << (mShiftX + mShiftY);
+            return tile | ((y & (tile_height() - 1)) << mShiftX) | (x & (tile_width() - 1));
+        }
+
+        constexpr reference       operator[](const point_type p)       { return mPtr[index(static_cast<std::size_t>(p[0]), static_cast<std::size_t>(p[1]))]; }
+        constexpr const_reference operator[](const point_type p) const { return mPtr[index(static_cast<std::size_t>(p[0]), static_cast<std::size_t>(p[1]))]; }
+
+        /// \brief  Tile (tx, ty) as a row-major view, clipped on the right and bottom edges.
+        constexpr matrix_view<Ty> tile(const std::size_t tx, const std::size_t ty) const {
+            const auto x = tx << mShiftX, y = ty << mShiftY;
+            return matrix_view<Ty>(mPtr + ((ty * mTilesX + tx) << (mShiftX + mShiftY)), 0, 0,
+                                   std::min(tile_width(), mWidth - x), std::min(tile_height(), mHeight - y), static_cast<std::ptrdiff_t>(tile_width()));
+        }
+    private:
+        pointer       mPtr    = nullptr;
+        std::size_t   mWidth  = 0, mHeight = 0;
+        std::uint32_t mShiftX = 0, mShiftY = 0;
+        std::size_t   mTilesX = 0;
+    };
+
+    ///
+    /// \class   morton_matrix_view
+    /// \brief   w x h elements stored in Z-order.
+    /// \details With side = bit_ceil(min(w, h)), element (x, y) lives in block (x | y) / side at
+    ///          morton_encode(x % side, y % side). Only the longer axis can reach past the first block.
+    /// \tparam  Ty - Element type.
+    ///
+    template <typename Ty>
+    class morton_matrix_view {
+    public:
+        using value_type      = Ty;
+        using reference       = value_type&;
+        using const_reference = const value_type&;
+        using pointer         = value_type*;
+        using const_pointer   = const value_type*;
+        using point_type      = typename matrix_view<Ty>::point_type;
+
+        constexpr morton_matrix_view() = default;
+        /// \param p - Pointer to at least storage_size(w, h) elements.
+        /// \param w - width
+        /// \param h - height
+        constexpr morton_matrix_view(const_pointer p, const std::size_t w, const std::size_t h)
+            : mPtr(const_cast<pointer>(p)), mWidth(w), mHeight(h), mShift(block_shift(w, h)) {}
+
+        static constexpr std::size_t storage_size(const std::size_t w, const std::size_t h) {
+            // Z-order grows in both x and y, so the last element is the largest index.
+            return w == 0 || h == 0 ? 0 : encode(w - 1, h - 1, block_shift(w, h)) + 1;
+        }
+
+        constexpr std::size_t   width()        const { return mWidth; }
+        constexpr std::size_t   height()       const { return mHeight; }
+        constexpr std::size_t   size()         const { return mWidth * mHeight; }
+        // Side of the square Z-order blocks.
+        constexpr std::size_t   block_side()   const { return std::size_t(1) << mShift; }
+        constexpr std::size_t   storage_size() const { return storage_size(mWidth, mHeight); }
+        constexpr pointer       data()               { return mPtr; }
+        constexpr const_pointer data()         const { return mPtr; }
+
+        /// \brief  Storage offset of element (x, y).
+        constexpr std::size_t index(const std::size_t x, const std::size_t y) const { return encode(x, y, mShift); }
+
+        constexpr reference       operator[](const point_type p)       { return mPtr[index(static_cast<std::size_t>(p[0]), static_cast<std::size_t>(p[1]))]; }
+        constexpr const_reference operator[](const point_type p) const { return mPtr[index(static_cast<std::size_t>(p[0]), static_cast<std::size_t>(p[1]))]; }
+    private:
+        static constexpr std::uint32_t block_shift(const std::size_t w, const std::size_t h) {
+            return static_cast<std::uint32_t>(std::countr_zero(std::bit_ceil(std::max<std::size_t>(1, std::min(w, h)))));
+        }
+        static constexpr std::size_t encode(const std::size_t x, const std::size_t y, const std::uint32_t shift) {
+            const auto mask = (std::size_t(1) << shift) - 1;
+            const auto in   = detail::morton_encode(static_cast<std::uint32_t>(x & mask), static_cast<std::uint32_t>(y & mask));
+            return static_cast<std::size_t>(in) | (((x | y) >> shift) << (2 * shift));
+        }
+
+        pointer       mPtr   = nullptr;
+        std::size_t   mWidth = 0, mHeight = 0;
+        std::uint32_t mShift = 0;
+    };
+
+    namespace detail {
+        // Z-order blocks this small are walked linearly instead of split further.
+        constexpr std::size_t morton_leaf_side = 8;
+        // (x, y) of the first morton_leaf_side^2 Z-order indices.
+        constexpr auto morton_leaf_table = [] {
+            std::array<std::pair<std::uint8_t, std::uint8_t>, morton_leaf_side * morton_leaf_side> t{};
+            for (std::size_t i = 0; i != t.size(); ++i) {
+                const auto [x, y] = morton_decode(i);
+                t[i] = { static_cast<std::uint8_t>(x), static_cast<std::uint8_t>(y) };
+            }
+            return t;
+        }();
+
+        // Visit the side x side Z-order block at (x0, y0) whose first element is p, skipping what lies outside w x h.
+        template <typename Ty, typename F>
+        constexpr void visit_morton(Ty* p, const std::size_t x0, const std::size_t y0, const std::size_t side,
+                                    const std::size_t w, const std::size_t h, F& f) {
+            if (x0 >= w || y0 >= h) return;
+            if (side <= morton_leaf_side) {
+                const auto n = side * side;
+                if (x0 + side <= w && y0 + side <= h) {
+                    for (std::size_t i = 0; i != n; ++i) { invoke_layout(f, p[i], x0 + morton_leaf_table[i].first, y0 + morton_leaf_table[i].second); }
+                    return;
+                }
+                for (std::size_t i = 0; i != n; ++i) {
+                    const auto x = x0 + morton_leaf_table[i].first, y = y0 + morton_leaf_table[i].second;
+                    if (x < w && y < h) { invoke_layout(f, p[i], x, y); }
+                }
+                return;
+            }
+            const auto half = side / 2, quarter = half * half;
+            visit_morton(p,               x0,        y0,        half, w, h, f);
+            visit_morton(p + quarter,     x0 + half, y0,        half, w, h, f);
+            visit_morton(p + 2 * quarter, x0,        y0 + half, half, w, h, f);
+            visit_morton(p + 3 * quarter, x0 + half, y0 + half, half, w, h, f);
+        }
+        template <typename Ty, typename F>
+        constexpr void visit_layout(tiled_matrix_view<Ty> view, F& f) {
+            for (std::size_t ty = 0; ty != view.tiles_y(); ++ty) {
+                for (std::size_t tx = 0; tx != view.tiles_x(); ++tx) {
+                    auto       tile = view.tile(tx, ty);
+                    const auto x0 = tx * view.tile_width(), y0 = ty * view.tile_height();
+                    for (std::size_t y = 0; y != tile.height(); ++y) {
+                        Ty* row = tile.data() + y * view.tile_width();
+                        for (std::size_t x = 0; x != tile.width(); ++x) { invoke_layout(f, row[x], x0 + x, y0 + y); }
+                    }
+                }
+            }
+        }
+        template <typename Ty, typename F>
+        constexpr void visit_layout(morton_matrix_view<Ty> view, F& f) {
+            const auto side  = view.block_side();
+            const auto along = view.width() >= view.height();
+            for (std::size_t b = 0, n = (std::max(view.width(), view.height()) + side - 1) / side; b != n; ++b) {
+                visit_morton(view.data() + b * side * side, along ? b * side : 0, along ? 0 : b * side, side, view.width(), view.height(), f);
+            }
+        }
+    }
+
+    /// \brief  Visit every element in storage order, f takes (element) or (element, x, y).
+    /// \example
+    /// std::vector<float> buffer(tiled_matrix_view<float>::storage_size(w, h, 32, 32));
+    /// tiled_matrix_view<float> tiled(buffer.data(), w, h, 32, 32);
+    /// copy_view_layout(src, tiled);
+    /// for_each_view(tiled, [](float& v, std::size_t x, std::size_t y) { v *= weight(x, y); });
+    template <typename Ty, typename F>
+    constexpr void for_each_view(tiled_matrix_view<Ty> view, F f) { detail::visit_layout(view, f); }
+    template <typename Ty, typename F>
+    constexpr void for_each_view(morton_matrix_view<Ty> view, F f) { detail::visit_layout(view, f); }
+
+    /// \brief  Copy elements in storage order to dest with the same rule as the matrix_view copy_view.
+    template <typename OutIt, typename Src, typename RuleF>
+    constexpr OutIt copy_view(const tiled_matrix_view<Src> view, OutIt dest, RuleF f) {
+        auto rule = [&](const Src& v) { std::invoke(f, dest, v); };
+        detail::visit_layout(view, rule);
+        return dest;
+    }
+    template <typename OutIt, typename Src, typename RuleF>
+    constexpr OutIt copy_view(const morton_matrix_view<Src> view, OutIt dest, RuleF f) {
+        auto rule = [&](const Src& v) { std::invoke(f, dest, v); };
+        detail::visit_layout(view, rule);
+        return dest;
+    }
+    template <typename OutIt, typename Ty> requires std::is_convertible_v<std::iter_value_t<OutIt>, Ty>
+    constexpr decltype(auto) copy_view(const tiled_matrix_view<Ty> view, OutIt dest) {
+        return copy_view(view, dest, [](OutIt& d, const Ty& v) { *d++ = v; });
+    }
+    template <typename OutIt, typename Ty> requires std::is_convertible_v<std::iter_value_t<OutIt>, Ty>
+    constexpr decltype(auto) copy_view(const morton_matrix_view<Ty> view, OutIt dest) {
+        return copy_view(view, dest, [](OutIt& d, const Ty& v) { *d++ = v; });
+    }
+
+    /// \brief  Convert row-major src into a tiled layout of the same size, one tile at a time.
+    template <typename Ty>
+    constexpr void copy_view_layout(const matrix_view<Ty> src, tiled_matrix_view<Ty> dest) {
+        for (std::size_t ty = 0; ty != dest.tiles_y(); ++ty) {
+            for (std::size_t tx = 0; tx != dest.tiles_x(); ++tx) {
+                auto tile = dest.tile(tx, ty);
+                copy_view_tiled(src.view(static_cast<std::ptrdiff_t>(tx * dest.tile_width()), static_cast<std::ptrdiff_t>(ty * dest.tile_height()),
+                                         tile.width(), tile.height()), tile);
+            }
+        }
+    }
+    /// \brief  Convert a tiled layout back into row-major dest of the same size.
+    template <typename Ty>
+    constexpr void copy_view_layout(const tiled_matrix_view<Ty> src, matrix_view<Ty> dest) {
+        for (std::size_t ty = 0; ty != src.tiles_y(); ++ty) {
+            for (std::size_t tx = 0; tx != src.tiles_x(); ++tx) {
+                auto tile = src.tile(tx, ty);
+                copy_view_tiled(tile, dest.view(static_cast<std::ptrdiff_t>(tx * src.tile_width()), static_cast<std::ptrdiff_t>(ty * src.tile_height()),
+                                                tile.width(), tile.height()));
+            }
+        }
+    }
+    /// \brief  Convert row-major src into Z-order, dest is written sequentially and src read block by block.
+    template <typename Ty>
+    constexpr void copy_view_layout(const matrix_view<Ty> src, morton_matrix_view<Ty> dest) {
+        const auto sr = src.row_delta(), sc = src.col_delta();
+        const Ty*  s  = src.data();
+        auto f = [&](Ty& v, const std::size_t x, const std::size_t y) {
+            v = s[static_cast<std::ptrdiff_t>(y) * sr + static_cast<std::ptrdiff_t>(x) * sc];
+        };
+        detail::visit_layout(dest, f);
+    }
+    /// \brief  Convert Z-order src back into row-major dest of the same size.
+    template <typename Ty>
+    constexpr void copy_view_layout(const morton_matrix_view<Ty> src, matrix_view<Ty> dest) {
+        const auto dr = dest.row_delta(), dc = dest.col_delta();
+        Ty*        d  = dest.data();
+        auto f = [&](const Ty& v, const std::size_t x, const std::size_t y) {
+            d[static_cast<std::ptrdiff_t>(y) * dr + static_cast<std::ptrdiff_t>(x) * dc] = v;
+        };
+        detail::visit_layout(src, f);
+    }
+}
@@ -7,11 +7,16 @@
 /// \copyright © HenryDu 2024. All right reserved.
 ///
 #pragma once
+#include <algorithm>
+#include <cstdint>
 #include <iterator>
+#include <stdexcept>
+#include <vector>
 
 #include "primary.hpp"
 #include "vector.hpp"
 #include "force/vector_view.hpp"
+#include "force/execution.hpp"
 namespace force {
     ///
     /// \class   matrix_view
@@ -178,6 +183,102 @@ namespace force {
     constexpr decltype(auto) for_each_view(matrix_view<Src> view, F f) {
         return for_each_view(view, f, [](auto&) {});
     }
+    // Order in which for_each_tile hands out tiles.
+    enum class tile_order {
+        row_major, // Left to right, top to bottom.
+        z_order    // Morton order, tiles close in time are close in both dimensions.
+    };
+
+    namespace detail {
+        // Insert a zero bit above every bit of v: abcd -> 0a0b0c0d.
+        constexpr std::uint64_t spread_bits(std::uint32_t v) {
+            std::uint64_t x = v;
+            x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+            x = (x | (x << 8))  & 0x00FF00FF00FF00FFULL;
+            x = (x | (x << 4))  & 0x0F0F0F0F0F0F0F0FULL;
+            x = (x | (x << 2))  & 0x3333333333333333ULL;
+            x = (x | (x << 1))  & 0x5555555555555555ULL;
+            return x;
+        }
+        constexpr std::uint64_t morton_encode(std::uint32_t x, std::uint32_t y) { return spread_bits(x) | (spread_bits(y) << 1); }
+
+        // Tile grid coordinates in traversal order.
+        inline std::vector<std::pair<std::size_t, std::size_t>> tile_sequence(std::size_t nx, std::size_t ny, tile_order order) {
+            std::vector<std::pair<std::size_t, std::size_t>> tiles;
+            tiles.reserve(nx * ny);
+            for (std::size_t y = 0; y != ny; ++y) {
+                for (std::size_t x = 0; x != nx; ++x) { tiles.emplace_back(x, y); }
+            }
+            if (order == tile_order::z_order) {
+                std::ranges::sort(tiles, {}, [](const auto& t) {
+                    return morton_encode(static_cast<std::uint32_t>(t.first), static_cast<std::uint32_t>(t.second));
+                });
+            }
+            return tiles;
+        }
+        inline void check_tile_extent(std::size_t tile_w, std::size_t tile_h) {
+            if (tile_w == 0 || tile_h == 0) throw std::runtime_error("Tile extent must not be zero!");
+        }
+    }
+    /// \brief  Edge of a square tile of Ty that fills about half of the given cache level, leaving the other
+    ///         half for what the tile is written to. Power of two, at least one cache line wide.
+    template <typename Ty>
+    inline std::size_t default_tile_extent(const bool l2 = false) {
+        const auto bytes = (l2 ? detail::cache_sizes().l2 : detail::cache_sizes().l1) / 2;
+        std::size_t e = std::max<std::size_t>(1, 64 / sizeof(Ty));
+        while ((e * 2) * (e * 2) * sizeof(Ty) <= bytes) { e *= 2; }
+        return e;
+    }
+    /// \brief  Call f(tile, x, y) for every tile_w x tile_h sub-view (smaller on the right and bottom edges),
+    ///         (x, y) is the tile's top left element. Throws if either tile extent is zero.
+    /// \example
+    /// for_each_tile(view, 64, 64, [&](auto tile, std::size_t x, std::size_t y) {
+    ///     transpose_view_copy(tile, out.view(y, x, tile.height(), tile.width()));
+    /// }, tile_order::z_order);
+    template <typename Ty, typename F>
+    void for_each_tile(matrix_view<Ty> view, const std::size_t tile_w, const std::size_t tile_h, F f, const tile_order order = tile_order::row_major) {
+        detail::check_tile_extent(tile_w, tile_h);
+        if (view.width() == 0 || view.height() == 0) return;
+        if (order == tile_order::row_major) {
+            for (std::size_t y = 0; y < view.height(); y += tile_h) {
+                for (std::size_t x = 0; x < view.width(); x += tile_w) {
+                    std::invoke(f, view.view(x, y, std::min(tile_w, view.width() - x), std::min(tile_h, view.height() - y)), x, y);
+                }
+            }
+            return;
+        }
+        for (auto [tx, ty] : detail::tile_sequence((view.width() + tile_w - 1) / tile_w, (view.height() + tile_h - 1) / tile_h, order)) {
+            auto x = tx * tile_w, y = ty * tile_h;
+            std::invoke(f, view.view(x, y, std::min(tile_w, view.width() - x), std::min(tile_h, view.height() - y)), x, y);
+        }
+    }
+    /// \brief  Tiled iteration with default_tile_extent<Ty>() square tiles.
+    template <typename Ty, typename F>
+    void for_each_tile(matrix_view<Ty> view, F f, const tile_order order = tile_order::row_major) {
+        const auto e = default_tile_extent<Ty>();
+        for_each_tile(view, e, e, f, order);
+    }
+    /// \brief  Parallel tiled iteration, each thread takes a contiguous run of the traversal order so its tiles
+    ///         stay close to each other. f is called concurrently and must only write inside its own tile.
+    template <typename Ty, typename F>
+    void for_each_tile(const execution::parallel_policy& policy, matrix_view<Ty> view, const std::size_t tile_w, const std::size_t tile_h, F f,
+                       const tile_order order = tile_order::row_major) {
+        detail::check_tile_extent(tile_w, tile_h);
+        if (view.width() == 0 || view.height() == 0) return;
+        const auto tiles = detail::tile_sequence((view.width() + tile_w - 1) / tile_w, (view.height() + tile_h - 1) / tile_h, order);
+        auto& pool = policy.executor();
+        detail::for_each_band(pool, tiles.size(), detail::band_count(tiles.size(), 1, pool), 1, [&](std::size_t, std::size_t beg, std::size_t end) {
+            for (auto i = beg; i != end; ++i) {
+                auto x = tiles[i].first * tile_w, y = tiles[i].second * tile_h;
+                std::invoke(f, view.view(x, y, std::min(tile_w, view.width() - x), std::min(tile_h, view.height() - y)), x, y);
+            }
+        });
+    }
+    template <typename Ty, typename F>
+    void for_each_tile(execution::sequenced_policy, matrix_view<Ty> view, const std::size_t tile_w, const std::size_t tile_h, F f,
+                       const tile_order order = tile_order::row_major) {
+        for_each_tile(view, tile_w, tile_h, f, order);
+    }
     /// \brief  Copy a view with desired copy rule.
     /// \tparam OutIt - Output iterator.
     /// \tparam Src   - View type.
@@ -247,27 +348,250 @@ namespace force {
         return matrix_view<Ty>(view.data(), 1 - view.width(), 1 - view.height(), view.width(), view.height(), -view.row_delta(), -view.col_delta());;
     }
 
+    // Materializing counterparts of the transformations above. A strided view is free to make but every
+    // consumer then walks memory by column, these write the transformed matrix into a destination instead.
+
+    namespace detail {
+        // Edge of a square tile whose source and destination both stay in L1 (about 16KB each).
+        template <typename Ty>
+        constexpr std::size_t view_tile_edge() {
+            std::size_t e = 8;
+            while (e < 64 && (e * 2) * (e * 2) * sizeof(Ty) <= 16384) { e *= 2; }
+            return e;
+        }
+    }
+    /// \brief  Copy a view of any strides into dest of the same size. When src is walked by column (transposed or
+    ///         rotated views) the copy goes tile by tile, so each source cache line and page is used by a whole
+    ///         tile row instead of a single element.
+    template <typename Ty>
+    constexpr void copy_view_tiled(const matrix_view<Ty> src, matrix_view<Ty> dest) {
+        const auto w  = static_cast<std::ptrdiff_t>(src.width());
+        const auto h  = static_cast<std::ptrdiff_t>(src.height());
+        const auto sr = src.row_delta(),  sc = src.col_delta();
+        const auto dr = dest.row_delta(), dc = dest.col_delta();
+        if (sc == 1 && dc == 1) {
+            for (std::ptrdiff_t y = 0; y != h; ++y) { std::copy_n(src.data() + y * sr, w, dest.data() + y * dr); }
+            return;
+        }
+        if (sc == 1 || sc == -1) {
+            for (std::ptrdiff_t y = 0; y != h; ++y) {
+                const auto* s = src.data() + y * sr;
+                auto*       d = dest.data() + y * dr;
+                for (std::ptrdiff_t x = 0; x != w; ++x) { d[x * dc] = s[x * sc]; }
+            }
+            return;
+        }
+        constexpr auto edge = static_cast<std::ptrdiff_t>(detail::view_tile_edge<Ty>());
+        for (std::ptrdiff_t ty = 0; ty < h; ty += edge) {
+            const auto th = std::min(edge, h - ty);
+            for (std::ptrdiff_t tx = 0; tx < w; tx += edge) {
+                const auto tw = std::min(edge, w - tx);
+                // Walk the tile in the source's storage order (down its columns) so reads are sequential.
+                for (std::ptrdiff_t x = tx; x != tx + tw; ++x) {
+                    const auto* s = src.data() + x * sc;
+                    auto*       d = dest.data() + x * dc;
+                    for (std::ptrdiff_t y = ty; y != ty + th; ++y) { d[y * dr] = s[y * sr]; }
+                }
+            }
+        }
+    }
+    /// \brief  Write the transpose of src into dest (dest is src.height() x src.width()).
+    template <typename Ty>
+    constexpr void transpose_view_copy(const matrix_view<Ty> src, matrix_view<Ty> dest) { copy_view_tiled(transpose_view(src), dest); }
+    /// \brief  Write src rotated 90 degrees counterclockwise into dest (dest is src.height() x src.width()).
+    template <typename Ty>
+    constexpr void rotate_view_half_pi_copy(const matrix_view<Ty> src, matrix_view<Ty> dest) { copy_view_tiled(rotate_view_half_pi(src), dest); }
+    /// \brief  Write src rotated 90 degrees clockwise into dest (dest is src.height() x src.width()).
+    template <typename Ty>
+    constexpr void rotate_view_neg_half_pi_copy(const matrix_view<Ty> src, matrix_view<Ty> dest) { copy_view_tiled(rotate_view_neg_half_pi(src), dest); }
+    /// \brief  Write src rotated 180 degrees into dest.
+    template <typename Ty>
+    constexpr void rotate_view_pi_copy(const matrix_view<Ty> src, matrix_view<Ty> dest) { copy_view_tiled(rotate_view_pi(src), dest); }
+    /// \brief  Write src flipped horizontally into dest.
+    template <typename Ty>
+    constexpr void reverse_row_view_copy(const matrix_view<Ty> src, matrix_view<Ty> dest) { copy_view_tiled(reverse_row_view(src), dest); }
+    /// \brief  Write src flipped vertically into dest.
+    template <typename Ty>
+    constexpr void reverse_col_view_copy(const matrix_view<Ty> src, matrix_view<Ty> dest) { copy_view_tiled(reverse_col_view(src), dest); }
+
+    namespace detail {
+        // Reverse n elements starting at p spaced by d.
+        template <typename Ty>
+        constexpr void reverse_strided(Ty* p, const std::ptrdiff_t n, const std::ptrdiff_t d) {
+            if (d == 1) { std::reverse(p, p + n); return; }
+            for (std::ptrdiff_t i = 0, j = n - 1; i < j; ++i, --j) { std::swap(p[i * d], p[j * d]); }
+        }
+        // Swap n elements of a and b, both spaced by d.
+        template <typename Ty>
+        constexpr void swap_strided(Ty* a, Ty* b, const std::ptrdiff_t n, const std::ptrdiff_t d) {
+            if (d == 1) { std::swap_ranges(a, a + n, b); return; }
+            for (std::ptrdiff_t i = 0; i != n; ++i) { std::swap(a[i * d], b[i * d]); }
+        }
+    }
+    /// \brief  Flip the content of view horizontally in place.
+    template <typename Ty>
+    constexpr void reverse_row_view_inplace(matrix_view<Ty> view) {
+        const auto w = static_cast<std::ptrdiff_t>(view.width());
+        for (std::ptrdiff_t y = 0; y != static_cast<std::ptrdiff_t>(view.height()); ++y) {
+            detail::reverse_strided(view.data() + y * view.row_delta(), w, view.col_delta());
+        }
+    }
+    /// \brief  Flip the content of view vertically in place, rows are swapped as a whole.
+    template <typename Ty>
+    constexpr void reverse_col_view_inplace(matrix_view<Ty> view) {
+        const auto w = static_cast<std::ptrdiff_t>(view.width());
+        const auto h = static_cast<std::ptrdiff_t>(view.height());
+        for (std::ptrdiff_t y = 0; y < h / 2; ++y) {
+            detail::swap_strided(view.data() + y * view.row_delta(), view.data() + (h - 1 - y) * view.row_delta(), w, view.col_delta());
+        }
+    }
+    /// \brief  Rotate the content of view 180 degrees in place, row y is swapped with row h - 1 - y read backwards.
+    template <typename Ty>
+    constexpr void rotate_view_pi_inplace(matrix_view<Ty> view) {
+        const auto w = static_cast<std::ptrdiff_t>(view.width());
+        const auto h = static_cast<std::ptrdiff_t>(view.height());
+        const auto d = view.col_delta();
+        for (std::ptrdiff_t y = 0; y < h / 2; ++y) {
+            auto* a = view.data() + y * view.row_delta();
+            auto* b = view.data() + (h - 1 - y) * view.row_delta() + (w - 1) * d;
+            for (std::ptrdiff_t x = 0; x != w; ++x) { std::swap(a[x * d], b[-x * d]); }
+        }
+        if (h % 2 != 0) { detail::reverse_strided(view.data() + (h / 2) * view.row_delta(), w, view.col_delta()); }
+    }
+
     // Projection transformation will need a new destination to store matrix after transformation.
 
+    namespace detail {
+        // Source index of destination index i when n source items are stretched over m, the source item under
+        // the destination item's centre: floor((i + 0.5) * n / m), computed exactly in integers.
+        constexpr std::ptrdiff_t scaled_index(const std::ptrdiff_t i, const std::size_t n, const std::size_t m) {
+            auto s = static_cast<std::ptrdiff_t>(((2 * static_cast<std::size_t>(i) + 1) * n) / (2 * m));
+            return force::clamp<std::ptrdiff_t>(s, 0, static_cast<std::ptrdiff_t>(n) - 1);
+        }
+    }
+
     template <typename Ty>
     constexpr decltype(auto) index_scaled_view(const matrix_view<Ty> src, const matrix_view<Ty> dest, vector_view<std::ptrdiff_t> p) {
-        using real_t = float64_t;
-        auto x = static_cast<std::ptrdiff_t>(force::round(static_cast<real_t>(p[0]) * static_cast<real_t>(dest.width())  / static_cast<real_t>(src.width())));
-        auto y = static_cast<std::ptrdiff_t>(force::round(static_cast<real_t>(p[1]) * static_cast<real_t>(dest.height()) / static_cast<real_t>(src.height())));
         return std::make_pair(
-            force::clamp<std::ptrdiff_t>(x, 0, src.width() - 1),
-            force::clamp<std::ptrdiff_t>(y, 0, src.height() - 1)
+            detail::scaled_index(p[0], src.width(),  dest.width()),
+            detail::scaled_index(p[1], src.height(), dest.height())
         );
     }
+    namespace detail {
+        // Source offset of every destination column, premultiplied by the source column delta.
+        template <typename Ty>
+        std::vector<std::ptrdiff_t> scaled_column_table(const matrix_view<Ty>& src, const matrix_view<Ty>& dest) {
+            std::vector<std::ptrdiff_t> cols(dest.width());
+            for (std::size_t dx = 0; dx != dest.width(); ++dx) {
+                cols[dx] = scaled_index(static_cast<std::ptrdiff_t>(dx), src.width(), dest.width()) * src.col_delta();
+            }
+            return cols;
+        }
+        // Nearest scale destination rows [beg, end).
+        template <typename Ty>
+        constexpr void scale_rows_nearest(const matrix_view<Ty>& src, matrix_view<Ty>& dest, const std::vector<std::ptrdiff_t>& cols,
+                                          const std::size_t beg, const std::size_t end) {
+            const auto     dd       = dest.col_delta();
+            std::ptrdiff_t previous = -1;
+            for (auto dy = beg; dy != end; ++dy) {
+                auto  sy = scaled_index(static_cast<std::ptrdiff_t>(dy), src.height(), dest.height());
+                auto* d  = dest.data() + static_cast<std::ptrdiff_t>(dy) * dest.row_delta();
+                if (sy == previous) {
+                    const auto* u = d - dest.row_delta();
+                    if (dd == 1) { std::copy_n(u, dest.width(), d); }
+                    else         { for (std::ptrdiff_t dx = 0; dx != static_cast<std::ptrdiff_t>(dest.width()); ++dx) { d[dx * dd] = u[dx * dd]; } }
+                    continue;
+                }
+                const auto* s = src.data() + sy * src.row_delta();
+                if (dd == 1) { for (std::size_t dx = 0; dx != dest.width(); ++dx) { d[dx] = s[cols[dx]]; } }
+                else         { for (std::ptrdiff_t dx = 0; dx != static_cast<std::ptrdiff_t>(dest.width()); ++dx) { d[dx * dd] = s[cols[dx]]; } }
+                previous = sy;
+            }
+        }
+    }
     // Nearest interpolation is good when you are trying to scale down an image -- lower its resolution.
+    // Source offsets of every column are computed once, each destination row is then a plain gather
+    // and rows that sample the same source row (upscaling) are copied from the row above.
     template <typename Ty>
     constexpr decltype(auto) scale_view_nearest(const matrix_view<Ty> src, matrix_view<Ty> dest) {
-        using point = vector<std::ptrdiff_t, 2>;
-        for (std::ptrdiff_t dy = 0; dy != dest.height(); ++dy) {
-            for (std::ptrdiff_t dx = 0; dx != dest.width(); ++dx) {
-                auto [sx, sy] = index_scaled_view(src, dest, point(dx, dy));
-                dest[point(dx, dy)] = src[point(sx, sy)];
-            }
+        if (dest.width() == 0 || dest.height() == 0 || src.width() == 0 || src.height() == 0) return;
+        detail::scale_rows_nearest(src, dest, detail::scaled_column_table(src, dest), 0, dest.height());
+    }
+
+    // Parallel overloads. Rows are split into bands that run on the policy's thread_pool, band edges are
+    // rounded so that two bands never write the same cache line and views smaller than
+    // detail::parallel_min_elements per band stay on the calling thread.
+    // Functions passed in are called concurrently from several threads.
+
+    namespace detail {
+        template <typename Ty, typename Fn>
+        void for_each_view_band(const execution::parallel_policy& policy, const matrix_view<Ty>& view, Fn f) {
+            auto& pool  = policy.executor();
+            auto  bands = band_count(view.height(), parallel_min_elements / (view.width() + 1) + 1, pool);
+            auto  align = band_alignment(view.row_delta() * static_cast<std::ptrdiff_t>(sizeof(Ty)));
+            for_each_band(pool, view.height(), bands, align, [&f](std::size_t, std::size_t beg, std::size_t end) { std::invoke(f, beg, end); });
         }
     }
+    /// \brief  Parallel for_each_view, fi is called for every element and fo after every row (rows in no particular order).
+    template <typename Src, typename F1, typename F2>
+    void for_each_view(const execution::parallel_policy& policy, matrix_view<Src> view, F1 fi, F2 fo) {
+        detail::for_each_view_band(policy, view, [&](std::size_t beg, std::size_t end) {
+            for (auto y = beg; y != end; ++y) {
+                auto row = view.row_at(static_cast<std::ptrdiff_t>(y));
+                for (auto& v : row) { std::invoke(fi, v); }
+                std::invoke(fo, *(view.row_begin() + static_cast<std::ptrdiff_t>(y)));
+            }
+        });
+    }
+    template <typename Src, typename F>
+    void for_each_view(const execution::parallel_policy& policy, matrix_view<Src> view, F f) {
+        for_each_view(policy, view, f, [](auto&) {});
+    }
+    /// \brief  Parallel copy_view, every band starts its own output iterator at dest + first row * width.
+    template <std::random_access_iterator OutIt, typename Src, typename RuleF>
+    OutIt copy_view(const execution::parallel_policy& policy, const matrix_view<Src> view, OutIt dest, RuleF f) {
+        detail::for_each_view_band(policy, view, [&](std::size_t beg, std::size_t end) {
+            auto out = dest + static_cast<std::ptrdiff_t>(beg * view.width());
+            copy_view(view.view(0, static_cast<std::ptrdiff_t>(beg), view.width(), end - beg), out, f);
+        });
+        return dest + static_cast<std::ptrdiff_t>(view.size());
+    }
+    template <std::random_access_iterator OutIt, typename Ty> requires std::is_convertible_v<std::iter_value_t<OutIt>, Ty>
+    OutIt copy_view(const execution::parallel_policy& policy, const matrix_view<Ty> view, OutIt dest) {
+        return copy_view(policy, view, dest, [](OutIt& d, const Ty& v) { *d++ = v; });
+    }
+    /// \brief  Parallel scale_view_nearest, the column table is shared by all bands.
+    template <typename Ty>
+    void scale_view_nearest(const execution::parallel_policy& policy, const matrix_view<Ty> src, matrix_view<Ty> dest) {
+        if (dest.width() == 0 || dest.height() == 0 || src.width() == 0 || src.height() == 0) return;
+        const auto cols = detail::scaled_column_table(src, dest);
+        detail::for_each_view_band(policy, dest, [&](std::size_t beg, std::size_t end) { detail::scale_rows_nearest(src, dest, cols, beg, end); });
+    }
+    /// \brief  view *= v on every element, the parallel form of matrix_view::operator*=.
+    template <typename Ty>
+    void multiply_view(const execution::parallel_policy& policy, matrix_view<Ty> view, const Ty v) {
+        detail::for_each_view_band(policy, view, [&](std::size_t beg, std::size_t end) { view.view(0, static_cast<std::ptrdiff_t>(beg), view.width(), end - beg) *= v; });
+    }
+    /// \brief  view /= v on every element, the parallel form of matrix_view::operator/=.
+    template <typename Ty>
+    void divide_view(const execution::parallel_policy& policy, matrix_view<Ty> view, const Ty v) {
+        detail::for_each_view_band(policy, view, [&](std::size_t beg, std::size_t end) { view.view(0, static_cast<std::ptrdiff_t>(beg), view.width(), end - beg) /= v; });
+    }
+
+    // Sequenced overloads so that generic code can forward whatever policy it was given.
+
+    template <typename Src, typename F1, typename F2>
+    constexpr decltype(auto) for_each_view(execution::sequenced_policy, matrix_view<Src> view, F1 fi, F2 fo) { return for_each_view(view, fi, fo); }
+    template <typename Src, typename F>
+    constexpr decltype(auto) for_each_view(execution::sequenced_policy, matrix_view<Src> view, F f) { return for_each_view(view, f); }
+    template <typename OutIt, typename Src, typename RuleF>
+    constexpr OutIt copy_view(execution::sequenced_policy, const matrix_view<Src> view, OutIt dest, RuleF f) { return copy_view(view, dest, f); }
+    template <typename OutIt, typename Ty> requires std::is_convertible_v<std::iter_value_t<OutIt>, Ty>
+    constexpr decltype(auto) copy_view(execution::sequenced_policy, const matrix_view<Ty> view, OutIt dest) { return copy_view(view, dest); }
+    template <typename Ty>
+    constexpr void scale_view_nearest(execution::sequenced_policy, const matrix_view<Ty> src, matrix_view<Ty> dest) { scale_view_nearest(src, dest); }
+    template <typename Ty>
+    constexpr void multiply_view(execution::sequenced_policy, matrix_view<Ty> view, const Ty v) { view *= v; }
+    template <typename Ty>
+    constexpr void divide_view(execution::sequenced_policy, matrix_view<Ty> view, const Ty v) { view /= v; }
 }
\ No newline at end of file
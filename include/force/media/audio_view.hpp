@@ -10,6 +10,7 @@
 
 #include "force/vector_view.hpp"
 #include "force/vector.hpp"
+#include "force/media/utility.hpp"
 
 namespace force::media {
     // Define three kinds of sample dots.
@@ -57,9 +58,9 @@ namespace force::media {
     template <audio_sample_concept ... Samples>
     class audio_variant_interleaved_view {
     public:
-        constexpr audio_variant_interleaved_view() :mViews() {}
-        template <interleaved_pixel_concept Ty>
-        constexpr audio_variant_interleaved_view(const audio_interleaved_view<Ty> view) : mViews(view) {}
+        constexpr audio_variant_interleaved_view() :mViews(), mSize(0) {}
+        template <audio_sample_concept Ty>
+        constexpr audio_variant_interleaved_view(const audio_interleaved_view<Ty> view) : mViews(view), mSize(view.size()) {}
         constexpr audio_variant_interleaved_view(const audio_variant_interleaved_view&) = default;
         constexpr audio_variant_interleaved_view(audio_variant_interleaved_view&&) = default;
 
@@ -71,9 +72,18 @@ namespace force::media {
         template <audio_sample_concept Ty>
         constexpr decltype(auto) get() const { return std::get<audio_interleaved_view<Ty>>(mViews); }
 
+        // Sample count is kept outside the variant so asking for it never needs a visit.
+        constexpr std::size_t size()  const { return mSize; }
+        constexpr std::size_t index() const { return mViews.index(); }
+
+        /// \brief Resolve the active sample type once and call f with the typed view (as an lvalue).
+        template <typename Fn>
+        constexpr decltype(auto) visit(Fn f) const { return detail::visit_view_variant(mViews, f); }
+
         ~audio_variant_interleaved_view() = default;
     private:
         std::variant<audio_interleaved_view<Samples>...> mViews;
+        std::size_t                                      mSize;
     };
 
 
@@ -0,0 +1,351 @@
+///
+/// \file      image_algorithm_convolution.hpp
+/// \brief     2D convolution: separable, direct, running-sum box and large Gaussian blurs.
+/// \details
+///
+/// The source is first loaded into a float buffer of channel arrays, so every pass below only walks flat
+/// float rows (this is what lets the inner loops vectorize) and src may alias dest.
+///
+/// - convolve_view checks whether the kernel is an outer product of a column and a row (rank one), in that
+///   case it runs a horizontal and a vertical 1D pass, O(kw + kh) per pixel instead of O(kw * kh).
+/// - box_blur_view keeps running sums, one add and one subtract per pixel whatever the radius is.
+/// - gaussian_blur_view samples the Gaussian for small sigma and uses three extended box passes
+///   (Gwosdek et al. 2011) for large sigma, so its cost does not grow with sigma.
+///
+/// Pixels outside the image are read through a border_policy. Rows are split into bands that run on
+/// several threads, a band reads the rows around it (its halo) directly from the shared input buffer.
+///
+/// \author    HenryDu
+/// \date      18.10.2026
+/// \copyright © HenryDu 2026. All right reserved.
+///
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "force/execution.hpp"
+#include "force/media/image_view.hpp"
+
+namespace force::media {
+    // How pixels outside the image are made up.
+    enum class border_policy {
+        clamp,   // Repeat the edge pixel:         aaa|abcd|ddd
+        mirror,  // Reflect without the edge:      dcb|abcd|cba
+        wrap     // Tile the image:                bcd|abcd|abc
+    };
+
+    namespace detail {
+        constexpr std::size_t convolution_min_pixels = 1 << 15;
+
+        constexpr std::ptrdiff_t border_index(std::ptrdiff_t i, const std::ptrdiff_t n, const border_policy border) {
+            if (i >= 0 && i < n) return i;
+            switch (border) {
+            case border_policy::clamp: return i < 0 ? 0 : n - 1;
+            case border_policy::wrap:  return ((i % n) + n) % n;
+            case border_policy::mirror: {
+                if (n == 1) return 0;
+                const auto period = 2 * n - 2;
+                i = ((i % period) + period) % period;
+                return i < n ? i : period - i;
+            }
+            }
+            return 0;
+        }
+
+        // Image as interleaved float channels, rows are packed.
+        struct convolution_buffer {
+            std::vector<float32_t> data;
+            std::size_t            width, height, channels;
+
+            convolution_buffer(std::size_t w, std::size_t h, std::size_t c) : data(w * h * c), width(w), height(h), channels(c) {}
+            std::size_t      stride()                const { return width * channels; }
+            float32_t*       row(std::ptrdiff_t y)         { return data.data() + y * stride(); }
+            const float32_t* row(std::ptrdiff_t y)   const { return data.data() + y * stride(); }
+        };
+
+        template <typename Fn>
+        void for_each_row_band(const std::size_t height, const std::size_t width, Fn f) {
+            auto bands = force::detail::band_count(height, convolution_min_pixels / (width + 1) + 1);
+            force::detail::for_each_band(height, bands, [&f](std::size_t, std::size_t beg, std::size_t end) {
+                for (auto y = beg; y != end; ++y) { std::invoke(f, static_cast<std::ptrdiff_t>(y)); }
+            });
+        }
+
+        template <typename Pix>
+        convolution_buffer load_convolution_buffer(const matrix_view<Pix> view) {
+            convolution_buffer buf(view.width(), view.height(), pixel_channels_v<Pix>);
+            for_each_row_band(view.height(), view.width(), [&](std::ptrdiff_t y) {
+                read_channel_row(view, y, buf.row(y), [](const auto v) { return static_cast<float32_t>(v); });
+            });
+            return buf;
+        }
+
+        template <typename Ty>
+        constexpr Ty convolution_narrow(float32_t v) {
+            if constexpr (std::is_floating_point_v<Ty>) { return static_cast<Ty>(v); }
+            else {
+                v = clamp(v, static_cast<float32_t>(std::numeric_limits<Ty>::min()), static_cast<float32_t>(std::numeric_limits<Ty>::max()));
+                return static_cast<Ty>(v < 0.F ? v - 0.5F : v + 0.5F);
+            }
+        }
+
+        template <typename Pix>
+        void store_convolution_buffer(const convolution_buffer& buf, matrix_view<Pix> view) {
+            using value_t = typename Pix::value_type;
+            for_each_row_band(view.height(), view.width(), [&](std::ptrdiff_t y) {
+                write_channel_row(view, y, buf.row(y), convolution_narrow<value_t>);
+            });
+        }
+
+        template <typename SrcPix, typename DstPix>
+        void check_convolution_size(const matrix_view<SrcPix>& src, const matrix_view<DstPix>& dest) {
+            if (src.width() != dest.width() || src.height() != dest.height()) throw std::runtime_error("Convolution source and destination size mismatch!");
+        }
+
+        // Copy row y of buf into padded with left pixels before it and right pixels after it made up by border.
+        inline void pad_convolution_row(const convolution_buffer& buf, std::ptrdiff_t y, std::ptrdiff_t left, std::ptrdiff_t right,
+                                        border_policy border, std::vector<float32_t>& padded) {
+            const auto c = static_cast<std::ptrdiff_t>(buf.channels);
+            const auto w = static_cast<std::ptrdiff_t>(buf.width);
+            padded.resize((w + left + right) * c);
+            const float32_t* s = buf.row(y);
+            for (std::ptrdiff_t x = -left; x != w + right; ++x) {
+                const float32_t* p = s + border_index(x, w, border) * c;
+                std::copy_n(p, c, padded.data() + (x + left) * c);
+            }
+        }
+
+        // out = in convolved along rows with taps, taps[anchor] is applied to the pixel itself.
+        inline void convolve_rows(const convolution_buffer& in, convolution_buffer& out, std::span<const float32_t> taps,
+                                  std::ptrdiff_t anchor, border_policy border) {
+            const auto n = static_cast<std::ptrdiff_t>(taps.size());
+            const auto c = in.channels;
+            for_each_row_band(in.height, in.width, [&](std::ptrdiff_t y) {
+                thread_local std::vector<float32_t> padded;
+                pad_convolution_row(in, y, anchor, n - 1 - anchor, border, padded);
+                float32_t* d = out.row(y);
+                std::fill_n(d, out.stride(), 0.F);
+                for (std::ptrdiff_t t = 0; t != n; ++t) {
+                    const float32_t  k = taps[t];
+                    const float32_t* s = padded.data() + t * c;
+                    if (k == 0.F) continue;
+                    for (std::size_t i = 0; i != out.stride(); ++i) { d[i] += k * s[i]; }
+                }
+            });
+        }
+        // out = in convolved along columns with taps, taps[anchor] is applied to the pixel itself.
+        inline void convolve_cols(const convolution_buffer& in, convolution_buffer& out, std::span<const float32_t> taps,
+                                  std::ptrdiff_t anchor, border_policy border) {
+            const auto n = static_cast<std::ptrdiff_t>(taps.size());
+            const auto h = static_cast<std::ptrdiff_t>(in.height);
+            for_each_row_band(in.height, in.width, [&](std::ptrdiff_t y) {
+                float32_t* d = out.row(y);
+                std::fill_n(d, out.stride(), 0.F);
+                for (std::ptrdiff_t t = 0; t != n; ++t) {
+                    const float32_t  k = taps[t];
+                    const float32_t* s = in.row(border_index(y - anchor + t, h, border));
+                    if (k == 0.F) continue;
+                    for (std::size_t i = 0; i != out.stride(); ++i) { d[i] += k * s[i]; }
+                }
+            });
+        }
+        // out = in convolved with a full kw x kh kernel (row major), O(kw * kh) per pixel.
+        inline void convolve_full(const convolution_buffer& in, convolution_buffer& out, const matrix_view<float32_t> kernel,
+                                  std::ptrdiff_t ax, std::ptrdiff_t ay, border_policy border) {
+            const auto kw = static_cast<std::ptrdiff_t>(kernel.width());
+            const auto kh = static_cast<std::ptrdiff_t>(kernel.height());
+            const auto h  = static_cast<std::ptrdiff_t>(in.height);
+            const auto c  = in.channels;
+            for_each_row_band(in.height, in.width, [&](std::ptrdiff_t y) {
+                thread_local std::vector<float32_t> padded;
+                float32_t* d = out.row(y);
+                std::fill_n(d, out.stride(), 0.F);
+                for (std::ptrdiff_t ky = 0; ky != kh; ++ky) {
+                    pad_convolution_row(in, border_index(y - ay + ky, h, border), ax, kw - 1 - ax, border, padded);
+                    for (std::ptrdiff_t kx = 0; kx != kw; ++kx) {
+                        const float32_t  k = kernel[vector<std::ptrdiff_t, 2>(kx, ky)];
+                        const float32_t* s = padded.data() + kx * c;
+                        if (k == 0.F) continue;
+                        for (std::size_t i = 0; i != out.stride(); ++i) { d[i] += k * s[i]; }
+                    }
+                }
+            });
+        }
+
+        // Running (extended) box along rows: out[x] = (sum(in[x - r, x + r]) + alpha * (in[x - r - 1] + in[x + r + 1])) / (2r + 1 + 2alpha).
+        inline void box_rows(const convolution_buffer& in, convolution_buffer& out, std::ptrdiff_t r, float32_t alpha, border_policy border) {
+            const auto c     = static_cast<std::ptrdiff_t>(in.channels);
+            const auto w     = static_cast<std::ptrdiff_t>(in.width);
+            const auto scale = 1.F / (static_cast<float32_t>(2 * r + 1) + 2.F * alpha);
+            for_each_row_band(in.height, in.width, [&](std::ptrdiff_t y) {
+                thread_local std::vector<float32_t> padded;
+                pad_convolution_row(in, y, r + 1, r + 1, border, padded);
+                // Item x of the row lives at p + x * c, -r - 1 <= x <= w + r.
+                const float32_t* p = padded.data() + (r + 1) * c;
+                float32_t*       d = out.row(y);
+                float64_t        sum[4] = {};
+                for (std::ptrdiff_t k = 0; k != c; ++k) {
+                    for (std::ptrdiff_t j = -r; j <= r; ++j) { sum[k] += p[j * c + k]; }
+                }
+                for (std::ptrdiff_t x = 0; x != w; ++x) {
+                    for (std::ptrdiff_t k = 0; k != c; ++k) {
+                        auto edge = p[(x - r - 1) * c + k] + p[(x + r + 1) * c + k];
+                        d[x * c + k] = (static_cast<float32_t>(sum[k]) + alpha * edge) * scale;
+                        sum[k] += p[(x + r + 1) * c + k] - p[(x - r) * c + k];
+                    }
+                }
+            });
+        }
+        // Running (extended) box along columns, each band starts its own sums from its halo rows.
+        inline void box_cols(const convolution_buffer& in, convolution_buffer& out, std::ptrdiff_t r, float32_t alpha, border_policy border) {
+            const auto h      = static_cast<std::ptrdiff_t>(in.height);
+            const auto stride = in.stride();
+            const auto scale  = 1.F / (static_cast<float32_t>(2 * r + 1) + 2.F * alpha);
+            auto bands = force::detail::band_count(in.height, convolution_min_pixels / (in.width + 1) + 1);
+            force::detail::for_each_band(in.height, bands, [&](std::size_t, std::size_t beg, std::size_t end) {
+                auto row = [&](std::ptrdiff_t y) { return in.row(border_index(y, h, border)); };
+                std::vector<float64_t> sum(stride, 0.0);
+                const auto first = static_cast<std::ptrdiff_t>(beg);
+                for (std::ptrdiff_t j = -r; j <= r; ++j) {
+                    const float32_t* s = row(first + j);
+                    for (std::size_t i = 0; i != stride; ++i) { sum[i] += s[i]; }
+                }
+                for (auto y = first; y != static_cast<std::ptrdiff_t>(end); ++y) {
+                    const float32_t* above = row(y - r - 1);
+                    const float32_t* below = row(y + r + 1);
+                    const float32_t* leave = row(y - r);
+                    float32_t*       d     = out.row(y);
+                    for (std::size_t i = 0; i != stride; ++i) {
+                        d[i]    = (static_cast<float32_t>(sum[i]) + alpha * (above[i] + below[i])) * scale;
+                        sum[i] += below[i] - leave[i];
+                    }
+                }
+            });
+        }
+
+        // Rank one test: kernel == column * row, both are returned when it is.
+        inline bool separate_kernel(const matrix_view<float32_t> kernel, std::vector<float32_t>& col, std::vector<float32_t>& row) {
+            using point = vector<std::ptrdiff_t, 2>;
+            const auto kw = static_cast<std::ptrdiff_t>(kernel.width());
+            const auto kh = static_cast<std::ptrdiff_t>(kernel.height());
+            // Pivot on the largest magnitude so the ratios are well conditioned.
+            std::ptrdiff_t px = 0, py = 0;
+            float32_t      largest = 0.F;
+            for (std::ptrdiff_t y = 0; y != kh; ++y) {
+                for (std::ptrdiff_t x = 0; x != kw; ++x) {
+                    auto v = std::abs(kernel[point(x, y)]);
+                    if (v > largest) { largest = v; px = x; py = y; }
+                }
+            }
+            if (largest == 0.F) return false;
+            const auto pivot     = kernel[point(px, py)];
+            const auto tolerance = largest * largest * 1e-5F;
+            for (std::ptrdiff_t y = 0; y != kh; ++y) {
+                for (std::ptrdiff_t x = 0; x != kw; ++x) {
+                    // k(x, y) * k(px, py) == k(px, y) * k(x, py) for every element of a rank one matrix.
+                    if (std::abs(kernel[point(x, y)] * pivot - kernel[point(px, y)] * kernel[point(x, py)]) > tolerance) return false;
+                }
+            }
+            col.resize(kh);
+            row.resize(kw);
+            for (std::ptrdiff_t y = 0; y != kh; ++y) { col[y] = kernel[point(px, y)] / pivot; }
+            for (std::ptrdiff_t x = 0; x != kw; ++x) { row[x] = kernel[point(x, py)]; }
+            return true;
+        }
+    }
+
+    /// \brief  Convolve with a separable kernel given as its horizontal and vertical taps, anchored at their centres.
+    template <interleaved_pixel_concept SrcPix, interleaved_pixel_concept DstPix>
+    void convolve_separable_view(const matrix_view<SrcPix> src, matrix_view<DstPix> dest, std::span<const float32_t> row_taps,
+                                 std::span<const float32_t> col_taps, const border_policy border = border_policy::clamp) {
+        static_assert(detail::pixel_channels_v<SrcPix> == detail::pixel_channels_v<DstPix>, "Channel count mismatch!");
+        detail::check_convolution_size(src, dest);
+        if (src.width() == 0 || src.height() == 0) return;
+        auto in  = detail::load_convolution_buffer(src);
+        auto mid = detail::convolution_buffer(in.width, in.height, in.channels);
+        detail::convolve_rows(in, mid, row_taps, static_cast<std::ptrdiff_t>(row_taps.size() / 2), border);
+        detail::convolve_cols(mid, in, col_taps, static_cast<std::ptrdiff_t>(col_taps.size() / 2), border);
+        detail::store_convolution_buffer(in, dest);
+    }
+    /// \brief  Convolve with a kw x kh kernel (correlation order, kernel(x, y) weights pixel (x - kw / 2, y - kh / 2)).
+    ///         Separable kernels are detected and run as two 1D passes.
+    /// \example
+    /// float32_t sharpen[9] = { 0, -1, 0, -1, 5, -1, 0, -1, 0 };
+    /// convolve_view(view, view, matrix_view<float32_t>(sharpen, 0, 0, 3, 3, 3));
+    template <interleaved_pixel_concept SrcPix, interleaved_pixel_concept DstPix>
+    void convolve_view(const matrix_view<SrcPix> src, matrix_view<DstPix> dest, const matrix_view<float32_t> kernel,
+                       const border_policy border = border_policy::clamp) {
+        static_assert(detail::pixel_channels_v<SrcPix> == detail::pixel_channels_v<DstPix>, "Channel count mismatch!");
+        detail::check_convolution_size(src, dest);
+        if (src.width() == 0 || src.height() == 0) return;
+        std::vector<float32_t> col, row;
+        if (kernel.width() > 1 && kernel.height() > 1 && detail::separate_kernel(kernel, col, row)) {
+            convolve_separable_view(src, dest, std::span<const float32_t>(row), std::span<const float32_t>(col), border);
+            return;
+        }
+        auto in  = detail::load_convolution_buffer(src);
+        auto out = detail::convolution_buffer(in.width, in.height, in.channels);
+        detail::convolve_full(in, out, kernel, static_cast<std::ptrdiff_t>(kernel.width() / 2), static_cast<std::ptrdiff_t>(kernel.height() / 2), border);
+        detail::store_convolution_buffer(out, dest);
+    }
+    /// \brief  Mean over a (2rx + 1) x (2ry + 1) window, cost per pixel is independent of the radii.
+    template <interleaved_pixel_concept SrcPix, interleaved_pixel_concept DstPix>
+    void box_blur_view(const matrix_view<SrcPix> src, matrix_view<DstPix> dest, const std::size_t rx, const std::size_t ry,
+                       const border_policy border = border_policy::clamp) {
+        static_assert(detail::pixel_channels_v<SrcPix> == detail::pixel_channels_v<DstPix>, "Channel count mismatch!");
+        static_assert(detail::pixel_channels_v<SrcPix> <= 4, "Running sums are kept for up to 4 channels!");
+        detail::check_convolution_size(src, dest);
+        if (src.width() == 0 || src.height() == 0) return;
+        auto in  = detail::load_convolution_buffer(src);
+        auto mid = detail::convolution_buffer(in.width, in.height, in.channels);
+        detail::box_rows(in, mid, static_cast<std::ptrdiff_t>(rx), 0.F, border);
+        detail::box_cols(mid, in, static_cast<std::ptrdiff_t>(ry), 0.F, border);
+        detail::store_convolution_buffer(in, dest);
+    }
+    /// \brief  Gaussian blur. Sigma up to 2 uses a sampled kernel of radius ceil(3 sigma), larger sigma is
+    ///         approximated by three extended box passes per axis at constant cost per pixel. Sigma 0 copies
+    ///         src, negative or NaN sigma throws std::runtime_error.
+    template <interleaved_pixel_concept SrcPix, interleaved_pixel_concept DstPix>
+    void gaussian_blur_view(const matrix_view<SrcPix> src, matrix_view<DstPix> dest, const float32_t sigma,
+                            const border_policy border = border_policy::clamp) {
+        static_assert(detail::pixel_channels_v<SrcPix> == detail::pixel_channels_v<DstPix>, "Channel count mismatch!");
+        static_assert(detail::pixel_channels_v<SrcPix> <= 4, "Running sums are kept for up to 4 channels!");
+        detail::check_convolution_size(src, dest);
+        if (!(sigma >= 0.F)) throw std::runtime_error("Gaussian sigma must be non-negative!");
+        if (src.width() == 0 || src.height() == 0) return;
+        if (sigma == 0.F) {
+            // Identity kernel, the exp below would be 0 / 0.
+            constexpr float32_t identity[] = {1.F};
+            convolve_separable_view(src, dest, std::span<const float32_t>(identity), std::span<const float32_t>(identity), border);
+            return;
+        }
+        if (sigma <= 2.F) {
+            const auto radius = static_cast<std::ptrdiff_t>(std::ceil(3.F * sigma));
+            std::vector<float32_t> taps(2 * radius + 1);
+            float32_t sum = 0.F;
+            for (std::ptrdiff_t i = -radius; i <= radius; ++i) {
+                taps[i + radius] = std::exp(-static_cast<float32_t>(i * i) / (2.F * sigma * sigma));
+                sum += taps[i + radius];
+            }
+            for (auto& t : taps) { t /= sum; }
+            convolve_separable_view(src, dest, std::span<const float32_t>(taps), std::span<const float32_t>(taps), border);
+            return;
+        }
+        // Extended box of radius r and edge weight alpha that has the variance of sigma^2 / passes.
+        constexpr auto passes   = 3;
+        const auto     variance = sigma * sigma / passes;
+        const auto     r        = static_cast<std::ptrdiff_t>(std::floor(0.5F * std::sqrt(12.F * variance + 1.F) - 0.5F));
+        const auto     rf       = static_cast<float32_t>(r);
+        const auto     alpha    = (2.F * rf + 1.F) * (rf * (rf + 1.F) - 3.F * variance) / (6.F * (variance - (rf + 1.F) * (rf + 1.F)));
+
+        auto in  = detail::load_convolution_buffer(src);
+        auto mid = detail::convolution_buffer(in.width, in.height, in.channels);
+        for (int i = 0; i != passes; ++i) { detail::box_rows(in, mid, r, alpha, border); std::swap(in, mid); }
+        for (int i = 0; i != passes; ++i) { detail::box_cols(in, mid, r, alpha, border); std::swap(in, mid); }
+        detail::store_convolution_buffer(in, dest);
+    }
+}
@@ -0,0 +1,214 @@
+///
+/// \file      image_algorithm_gamma.hpp
+/// \brief     sRGB transfer function (8bit sRGB <-> linear light) based on lookup tables.
+/// \details
+///
+/// Resizing and blending must happen in linear light, but evaluating the sRGB curve with force::pow
+/// costs two transcendental functions per channel. Decoding is a 256 entries lookup (8bit input can only
+/// have 256 values), encoding from float uses a piecewise linear table indexed directly by the float's
+/// exponent and top mantissa bits, encoding from 16bit linear is a 4096 entries lookup.
+///
+/// srgb_to_linear and linear_to_srgb are function objects, so besides the view kernels below they can
+/// be handed to other algorithms (resampling, blending ...) as fused decode/encode stages.
+///
+/// \author    HenryDu
+/// \date      18.10.2026
+/// \copyright © HenryDu 2026. All right reserved.
+///
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cmath>
+
+#include "force/media/image_view.hpp"
+
+namespace force::media {
+    namespace detail {
+        // Exact curves, only used once to build the tables.
+        inline float64_t srgb_decode_exact(const float64_t v) {
+            return v <= 0.04045 ? v / 12.92 : std::pow((v + 0.055) / 1.055, 2.4);
+        }
+        inline float64_t srgb_encode_exact(const float64_t v) {
+            return v <= 0.0031308 ? v * 12.92 : 1.055 * std::pow(v, 1.0 / 2.4) - 0.055;
+        }
+
+        struct srgb_tables {
+            // Encoding table covers [2^-13, 1), anything below encodes to 0 anyway.
+            // One bucket is 1/8 of an octave: 13 octaves * 8 = 104 buckets.
+            static constexpr std::uint32_t encode_min_bits     = 0x3900'0000U; // 2^-13
+            static constexpr std::uint32_t encode_max_bits     = 0x3F7F'FFFFU; // The float right below 1.
+            static constexpr std::uint32_t encode_bucket_shift = 20U;
+            static constexpr std::size_t   encode_buckets      = 104;
+
+            std::array<float32_t, 256>                decode_f32;
+            std::array<std::uint16_t, 256>            decode_u16;
+            std::array<std::uint8_t, 4096>            encode_u16;  // Indexed by (linear u16 >> 4).
+            std::array<float32_t, encode_buckets + 1> encode_knot; // Encoded value (0 - 255) at bucket starts.
+
+            srgb_tables() {
+                for (std::size_t i = 0; i != decode_f32.size(); ++i) {
+                    auto l = srgb_decode_exact(static_cast<float64_t>(i) / 255.0);
+                    decode_f32[i] = static_cast<float32_t>(l);
+                    decode_u16[i] = static_cast<std::uint16_t>(l * 65535.0 + 0.5);
+                }
+                for (std::size_t i = 0; i != encode_u16.size(); ++i) {
+                    // Sample the centre of the 16 values sharing one entry.
+                    auto l = (static_cast<float64_t>(i << 4) + 7.5) / 65535.0;
+                    encode_u16[i] = static_cast<std::uint8_t>(srgb_encode_exact(l > 1.0 ? 1.0 : l) * 255.0 + 0.5);
+                }
+                for (std::size_t i = 0; i != encode_knot.size(); ++i) {
+                    auto x = std::bit_cast<float32_t>(static_cast<std::uint32_t>(encode_min_bits + (i << encode_bucket_shift)));
+                    encode_knot[i] = static_cast<float32_t>(srgb_encode_exact(static_cast<float64_t>(x)) * 255.0);
+                }
+            }
+        };
+        inline const srgb_tables& get_srgb_tables() {
+            static const srgb_tables tables;
+            return tables;
+        }
+    }
+
+    /////////////////////////////////////////
+    ///        SCALAR TRANSFER STAGES     ///
+    /////////////////////////////////////////
+    struct srgb_to_linear_proto {
+        // 8bit sRGB to linear light in [0, 1].
+        float32_t     operator()(const std::uint8_t v) const { return detail::get_srgb_tables().decode_f32[v]; }
+        // 8bit sRGB to linear light in [0, 65535].
+        std::uint16_t to_u16(const std::uint8_t v)    const { return detail::get_srgb_tables().decode_u16[v]; }
+    };
+    inline const auto srgb_to_linear = srgb_to_linear_proto{};
+
+    struct linear_to_srgb_proto {
+        // Linear light in [0, 1] (clamped) to 8bit sRGB.
+        std::uint8_t operator()(const float32_t v) const {
+            using tables = detail::srgb_tables;
+            const auto& t = detail::get_srgb_tables();
+            // Clamp on the bit pattern, negative numbers and NaN become huge unsigned values so compare as float first.
+            auto c = v > 0.F ? v : 0.F;
+            auto i = std::bit_cast<std::uint32_t>(c);
+            i = i < tables::encode_min_bits ? tables::encode_min_bits : i > tables::encode_max_bits ? tables::encode_max_bits : i;
+            auto k = i - tables::encode_min_bits;
+            auto b = k >> tables::encode_bucket_shift;
+            auto f = static_cast<float32_t>(k & ((1U << tables::encode_bucket_shift) - 1)) * (1.F / static_cast<float32_t>(1U << tables::encode_bucket_shift));
+            auto y = t.encode_knot[b] + (t.encode_knot[b + 1] - t.encode_knot[b]) * f;
+            return static_cast<std::uint8_t>(y + 0.5F);
+        }
+        // Linear light in [0, 65535] to 8bit sRGB.
+        std::uint8_t operator()(const std::uint16_t v) const { return detail::get_srgb_tables().encode_u16[v >> 4]; }
+    };
+    inline const auto linear_to_srgb = linear_to_srgb_proto{};
+
+    /////////////////////////////////////////
+    ///            VIEW KERNELS           ///
+    /////////////////////////////////////////
+
+    /// \brief  Decode an 8bit sRGB view into a linear view, every channel but alpha goes through the sRGB curve.
+    /// \tparam SrcPix        - Any pixel whose value_type is uint8_t.
+    /// \tparam DstPix        - Pixel with the same channel count, float value_type gives [0, 1], uint16_t gives [0, 65535].
+    /// \param  src           - Source view.
+    /// \param  dest          - Destination view, must be at least as large as src.
+    /// \param  alpha_channel - Channel index of alpha, that channel is only rescaled. Negative if there is none.
+    template <interleaved_pixel_concept SrcPix, interleaved_pixel_concept DstPix>
+        requires std::is_same_v<typename SrcPix::value_type, std::uint8_t>
+    void srgb_to_linear_view(const matrix_view<SrcPix> src, matrix_view<DstPix> dest, const std::ptrdiff_t alpha_channel = -1) {
+        using dst_value_t = typename DstPix::value_type;
+        static_assert(detail::pixel_channels_v<SrcPix> == detail::pixel_channels_v<DstPix>, "Channel count mismatch!");
+        static_assert(std::is_floating_point_v<dst_value_t> || std::is_same_v<dst_value_t, std::uint16_t>, "Linear pixel must be float or uint16!");
+        constexpr auto channels = detail::pixel_channels_v<SrcPix>;
+
+        const auto& t = detail::get_srgb_tables();
+        const auto* table = [&t] {
+            if constexpr (std::is_floating_point_v<dst_value_t>) { return t.decode_f32.data(); }
+            else                                                  { return t.decode_u16.data(); }
+        }();
+        auto map_alpha = [](const std::uint8_t v) {
+            if constexpr (std::is_floating_point_v<dst_value_t>) { return static_cast<dst_value_t>(static_cast<float32_t>(v) * (1.F / 255.F)); }
+            else                                                  { return static_cast<dst_value_t>(v * 257U); }
+        };
+        for (std::size_t y = 0; y != src.height(); ++y) {
+            if (alpha_channel < 0 && detail::is_same_flat_layout(src, dest)) {
+                const std::uint8_t* s = detail::flat_row_data(src, y);
+                dst_value_t*        d = detail::flat_row_data(dest, y);
+                for (std::size_t i = 0; i != src.width() * channels; ++i) { d[i] = static_cast<dst_value_t>(table[s[i]]); }
+                continue;
+            }
+            auto sr = src.row_at(y);
+            auto dr = dest.row_at(y);
+            for (std::size_t x = 0; x != src.width(); ++x) {
+                for (std::size_t c = 0; c != channels; ++c) {
+                    const std::uint8_t v = sr[x][c];
+                    dr[x][c] = static_cast<std::ptrdiff_t>(c) == alpha_channel ? map_alpha(v) : static_cast<dst_value_t>(table[v]);
+                }
+            }
+        }
+    }
+    /// \brief  Encode a linear view (float in [0, 1] or uint16_t in [0, 65535]) into an 8bit sRGB view.
+    /// \param  alpha_channel - Channel index of alpha, that channel is only rescaled. Negative if there is none.
+    template <interleaved_pixel_concept SrcPix, interleaved_pixel_concept DstPix>
+        requires std::is_same_v<typename DstPix::value_type, std::uint8_t>
+    void linear_to_srgb_view(const matrix_view<SrcPix> src, matrix_view<DstPix> dest, const std::ptrdiff_t alpha_channel = -1) {
+        using src_value_t = typename SrcPix::value_type;
+        static_assert(detail::pixel_channels_v<SrcPix> == detail::pixel_channels_v<DstPix>, "Channel count mismatch!");
+        static_assert(std::is_floating_point_v<src_value_t> || std::is_same_v<src_value_t, std::uint16_t>, "Linear pixel must be float or uint16!");
+        constexpr auto channels = detail::pixel_channels_v<SrcPix>;
+
+        auto encode = [](const src_value_t v) {
+            if constexpr (std::is_floating_point_v<src_value_t>) { return linear_to_srgb(static_cast<float32_t>(v)); }
+            else                                                  { return linear_to_srgb(v); }
+        };
+        auto map_alpha = [](const src_value_t v) {
+            if constexpr (std::is_floating_point_v<src_value_t>) { return static_cast<std::uint8_t>(clamp(static_cast<float32_t>(v), 0.F, 1.F) * 255.F + 0.5F); }
+            else                                                  { return static_cast<std::uint8_t>((v + 128U) / 257U); }
+        };
+        for (std::size_t y = 0; y != src.height(); ++y) {
+            if (alpha_channel < 0 && detail::is_same_flat_layout(src, dest)) {
+                const src_value_t* s = detail::flat_row_data(src, y);
+                std::uint8_t*      d = detail::flat_row_data(dest, y);
+                for (std::size_t i = 0; i != src.width() * channels; ++i) { d[i] = encode(s[i]); }
+                continue;
+            }
+            auto sr = src.row_at(y);
+            auto dr = dest.row_at(y);
+            for (std::size_t x = 0; x != src.width(); ++x) {
+                for (std::size_t c = 0; c != channels; ++c) {
+                    const src_value_t v = sr[x][c];
+                    dr[x][c] = static_cast<std::ptrdiff_t>(c) == alpha_channel ? map_alpha(v) : encode(v);
+                }
+            }
+        }
+    }
+    /// \brief  Gamma correct blend of two 8bit sRGB views: dest = encode(lerp(decode(a), decode(b), t)).
+    /// \param  t             - Weight of b, 0 gives a and 1 gives b.
+    /// \param  alpha_channel - Channel index of alpha, that channel is blended as it is. Negative if there is none.
+    template <interleaved_pixel_concept Pix> requires std::is_same_v<typename Pix::value_type, std::uint8_t>
+    void lerp_view_srgb(const matrix_view<Pix> a, const matrix_view<Pix> b, matrix_view<Pix> dest, const float32_t t,
+                        const std::ptrdiff_t alpha_channel = -1) {
+        constexpr auto channels = detail::pixel_channels_v<Pix>;
+        auto blend = [t](const std::uint8_t u, const std::uint8_t v) {
+            return linear_to_srgb(lerp_ac(srgb_to_linear(u), srgb_to_linear(v), t));
+        };
+        auto blend_alpha = [t](const std::uint8_t u, const std::uint8_t v) {
+            return static_cast<std::uint8_t>(clamp(lerp_ac(static_cast<float32_t>(u), static_cast<float32_t>(v), t), 0.F, 255.F) + 0.5F);
+        };
+        for (std::size_t y = 0; y != dest.height(); ++y) {
+            if (alpha_channel < 0 && detail::is_flat_view(a) && detail::is_flat_view(b) && detail::is_flat_view(dest)) {
+                const std::uint8_t* s0 = detail::flat_row_data(a, y);
+                const std::uint8_t* s1 = detail::flat_row_data(b, y);
+                std::uint8_t*       d  = detail::flat_row_data(dest, y);
+                for (std::size_t i = 0; i != dest.width() * channels; ++i) { d[i] = blend(s0[i], s1[i]); }
+                continue;
+            }
+            auto r0 = a.row_at(y);
+            auto r1 = b.row_at(y);
+            auto dr = dest.row_at(y);
+            for (std::size_t x = 0; x != dest.width(); ++x) {
+                for (std::size_t c = 0; c != channels; ++c) {
+                    const std::uint8_t u = r0[x][c], v = r1[x][c];
+                    dr[x][c] = static_cast<std::ptrdiff_t>(c) == alpha_channel ? blend_alpha(u, v) : blend(u, v);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,301 @@
+///
+/// \file      image_algorithm_hash.hpp
+/// \brief     Perceptual image hashes (aHash, dHash, pHash) and Hamming distance search for deduplication.
+/// \details
+///
+/// Every hash is 64 bits, bit i belongs to cell i of the 8x8 grid in row major order (LSB first). Similar
+/// images give hashes a few bits apart, compare them with hamming_distance.
+///
+/// - aHash: 8x8 area average, bit set when the cell is brighter than the mean of all cells.
+/// - dHash: 9x8 area average, bit set when a cell is brighter than its left neighbour.
+/// - pHash: 32x32 area average, DCT-II, bit set when one of the 8x8 lowest frequency coefficients is
+///   above their median.
+///
+/// Pixels are reduced to the plain sum of their channels. The hashes only compare cells to each other,
+/// so they don't change with a constant offset or gain, and a constant alpha channel has no effect.
+///
+/// The source is read once: every row is added into a per column accumulator (integer for integer
+/// channels) until a grid row is done, then the accumulator is reduced to the grid cells. The DCT only
+/// computes the 8x8 coefficients the hash needs as two small matrix products against a cosine table
+/// (about 10k multiply-adds instead of a full 32x32 transform), written so both loops vectorize.
+///
+/// image_hash_views hashes a batch of images with one image per task, which beats splitting single
+/// thumbnails into row bands.
+///
+/// \author    HenryDu
+/// \date      18.10.2026
+/// \copyright © HenryDu 2026. All right reserved.
+///
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "force/execution.hpp"
+#include "force/media/image_view.hpp"
+
+namespace force::media {
+    /// \brief  Kind of perceptual hash.
+    enum class image_hash { average, difference, perceptual };
+
+    namespace detail {
+        constexpr std::size_t hash_min_pixels   = 1 << 16;
+        constexpr std::size_t hash_min_compares = 1 << 16;
+        constexpr std::size_t hash_chunk        = 64;
+        constexpr std::size_t hash_dct_size     = 32;
+        constexpr std::size_t hash_dct_low      = 8;
+
+        // Per column channel sum, integer for integer channels so the adds vectorize exactly. 32 bits hold
+        // 16M rows of 8bit values, wider channels take 64 bits.
+        template <typename Ty>
+        using hash_accumulator = std::conditional_t<!std::is_integral_v<Ty>, float32_t,
+                                 std::conditional_t<(sizeof(Ty) == 1), std::conditional_t<std::is_signed_v<Ty>, std::int32_t, std::uint32_t>,
+                                                                       std::conditional_t<std::is_signed_v<Ty>, std::int64_t, std::uint64_t>>>;
+        // Sum of a whole grid cell, which adds the columns of every channel.
+        template <typename Acc>
+        using hash_cell_sum = std::conditional_t<std::is_floating_point_v<Acc>, float64_t,
+                              std::conditional_t<std::is_signed_v<Acc>, std::int64_t, std::uint64_t>>;
+
+        // First source index of grid cell i out of n cells over size elements. Cells never get empty, when
+        // the source is smaller than the grid neighbouring cells share a pixel.
+        inline std::size_t hash_cell_begin(const std::size_t i, const std::size_t n, const std::size_t size) {
+            return std::min(i * size / n, size - 1);
+        }
+        inline std::size_t hash_cell_end(const std::size_t i, const std::size_t n, const std::size_t size) {
+            return std::max((i + 1) * size / n, hash_cell_begin(i, n, size) + 1);
+        }
+
+        // sum[i] += src[i], whole chunks go through a local array so the compiler doesn't check src and sum
+        // against each other for aliasing (which keeps byte loops from vectorizing).
+        template <typename Ty, typename Acc>
+        void hash_add_row(const Ty* src, Acc* sum, const std::size_t n) {
+            std::size_t i0 = 0;
+            for (; i0 + hash_chunk <= n; i0 += hash_chunk) {
+                std::array<Acc, hash_chunk> s;
+                std::copy_n(sum + i0, hash_chunk, s.data());
+                for (std::size_t i = 0; i != hash_chunk; ++i) { s[i] += static_cast<Acc>(src[i0 + i]); }
+                std::copy_n(s.data(), hash_chunk, sum + i0);
+            }
+            for (; i0 != n; ++i0) { sum[i0] += static_cast<Acc>(src[i0]); }
+        }
+
+        // Area average of view into a gw x gh grid of channel sums, grid rows are split into bands.
+        template <typename Pix>
+        void hash_grid(const matrix_view<Pix>& view, const std::size_t gw, const std::size_t gh, float32_t* grid, const std::size_t bands) {
+            using value_type = typename Pix::value_type;
+            using acc_type   = hash_accumulator<value_type>;
+            using cell_type  = hash_cell_sum<acc_type>;
+            constexpr auto channels = pixel_channels_v<Pix>;
+            const auto     w        = view.width();
+            const auto     h        = view.height();
+            if (w == 0 || h == 0) throw std::runtime_error("Cannot hash an empty image!");
+
+            force::detail::for_each_band(gh, bands, [&](std::size_t, std::size_t beg, std::size_t end) {
+                std::vector<value_type> row(w * channels);
+                std::vector<acc_type>   sum(w * channels);
+                for (auto gy = beg; gy != end; ++gy) {
+                    const auto y0 = hash_cell_begin(gy, gh, h), y1 = hash_cell_end(gy, gh, h);
+                    std::ranges::fill(sum, acc_type{});
+                    for (auto y = y0; y != y1; ++y) {
+                        // Channel order doesn't matter for the sums, flat rows are added straight from the image.
+                        if constexpr (flat_pixel_concept<Pix>) {
+                            if (is_flat_view(view)) {
+                                hash_add_row(flat_row_data(view, static_cast<std::ptrdiff_t>(y)), sum.data(), sum.size());
+                                continue;
+                            }
+                        }
+                        read_channel_row(view, static_cast<std::ptrdiff_t>(y), row.data(), std::identity{});
+                        hash_add_row(row.data(), sum.data(), sum.size());
+                    }
+                    for (std::size_t gx = 0; gx != gw; ++gx) {
+                        const auto x0 = hash_cell_begin(gx, gw, w), x1 = hash_cell_end(gx, gw, w);
+                        cell_type  s  = 0;
+                        for (auto i = x0 * channels; i != x1 * channels; ++i) { s += static_cast<cell_type>(sum[i]); }
+                        grid[gy * gw + gx] = static_cast<float32_t>(static_cast<float64_t>(s) / static_cast<float64_t>((x1 - x0) * (y1 - y0)));
+                    }
+                }
+            });
+        }
+
+        // cos(pi * (2 * n + 1) * k / 64) for the low frequencies k < 8, as [k][n] and transposed as [n][k].
+        struct hash_dct_table {
+            std::array<float32_t, hash_dct_low * hash_dct_size> rows;
+            std::array<float32_t, hash_dct_size * hash_dct_low> cols;
+
+            hash_dct_table() {
+                for (std::size_t k = 0; k != hash_dct_low; ++k) {
+                    for (std::size_t n = 0; n != hash_dct_size; ++n) {
+                        const auto c = static_cast<float32_t>(std::cos(std::numbers::pi * static_cast<float64_t>((2 * n + 1) * k) /
+                                                                       static_cast<float64_t>(2 * hash_dct_size)));
+                        rows[k * hash_dct_size + n] = c;
+                        cols[n * hash_dct_low + k]  = c;
+                    }
+                }
+            }
+        };
+        inline const hash_dct_table& dct_table() {
+            static const hash_dct_table table;
+            return table;
+        }
+
+        // Unnormalized DCT-II of a 32x32 grid, only the top left 8x8 coefficients (row major into out).
+        inline void dct32_low(const float32_t* grid, float32_t* out) {
+            const auto& table = dct_table();
+            // Columns first: tmp[u][x] = sum_y cos[u][y] * grid[y][x].
+            std::array<float32_t, hash_dct_low * hash_dct_size> tmp{};
+            for (std::size_t u = 0; u != hash_dct_low; ++u) {
+                auto* t = tmp.data() + u * hash_dct_size;
+                for (std::size_t y = 0; y != hash_dct_size; ++y) {
+                    const auto  c = table.rows[u * hash_dct_size + y];
+                    const auto* g = grid + y * hash_dct_size;
+                    for (std::size_t x = 0; x != hash_dct_size; ++x) { t[x] += c * g[x]; }
+                }
+            }
+            // Then rows: out[u][v] = sum_x tmp[u][x] * cos[v][x], accumulated over x so v is the inner loop.
+            std::array<float32_t, hash_dct_low * hash_dct_low> res{};
+            for (std::size_t u = 0; u != hash_dct_low; ++u) {
+                auto* r = res.data() + u * hash_dct_low;
+                for (std::size_t x = 0; x != hash_dct_size; ++x) {
+                    const auto  t = tmp[u * hash_dct_size + x];
+                    const auto* c = table.cols.data() + x * hash_dct_low;
+                    for (std::size_t v = 0; v != hash_dct_low; ++v) { r[v] += t * c[v]; }
+                }
+            }
+            std::ranges::copy(res, out);
+        }
+
+        template <typename Pix>
+        std::uint64_t average_hash(const matrix_view<Pix>& view, const std::size_t bands) {
+            std::array<float32_t, 64> grid;
+            hash_grid(view, 8, 8, grid.data(), bands);
+            float32_t mean = 0.0f;
+            for (auto v : grid) { mean += v; }
+            mean /= 64.0f;
+            std::uint64_t hash = 0;
+            for (std::size_t i = 0; i != 64; ++i) { hash |= static_cast<std::uint64_t>(grid[i] > mean) << i; }
+            return hash;
+        }
+        template <typename Pix>
+        std::uint64_t difference_hash(const matrix_view<Pix>& view, const std::size_t bands) {
+            std::array<float32_t, 72> grid;
+            hash_grid(view, 9, 8, grid.data(), bands);
+            std::uint64_t hash = 0;
+            for (std::size_t y = 0; y != 8; ++y) {
+                for (std::size_t x = 0; x != 8; ++x) {
+                    hash |= static_cast<std::uint64_t>(grid[y * 9 + x + 1] > grid[y * 9 + x]) << (y * 8 + x);
+                }
+            }
+            return hash;
+        }
+        template <typename Pix>
+        std::uint64_t perceptual_hash(const matrix_view<Pix>& view, const std::size_t bands) {
+            std::array<float32_t, hash_dct_size * hash_dct_size> grid;
+            std::array<float32_t, 64> low;
+            hash_grid(view, hash_dct_size, hash_dct_size, grid.data(), bands);
+            dct32_low(grid.data(), low.data());
+            // Median of an even count, the mean of the two middle values.
+            auto sorted = low;
+            std::ranges::nth_element(sorted, sorted.begin() + 32);
+            const auto median = (sorted[32] + *std::ranges::max_element(sorted.begin(), sorted.begin() + 32)) * 0.5f;
+            std::uint64_t hash = 0;
+            for (std::size_t i = 0; i != 64; ++i) { hash |= static_cast<std::uint64_t>(low[i] > median) << i; }
+            return hash;
+        }
+        template <typename Pix>
+        std::uint64_t image_hash_of(const matrix_view<Pix>& view, const image_hash kind, const std::size_t bands) {
+            switch (kind) {
+            case image_hash::average:    return average_hash(view, bands);
+            case image_hash::difference: return difference_hash(view, bands);
+            case image_hash::perceptual: return perceptual_hash(view, bands);
+            }
+            throw std::runtime_error("Unknown image hash!");
+        }
+        // Grid rows per band so that every band reads at least hash_min_pixels source pixels.
+        template <typename Pix>
+        std::size_t hash_bands(const matrix_view<Pix>& view, const std::size_t grid_rows) {
+            const auto rows = view.height() / grid_rows + 1;
+            return force::detail::band_count(grid_rows, hash_min_pixels / (rows * (view.width() + 1)) + 1);
+        }
+
+        // Bit count without a popcnt instruction, plain shifts and adds that vectorize over hash arrays.
+        constexpr std::uint64_t hash_popcount(std::uint64_t x) {
+            x -= (x >> 1) & 0x5555555555555555ull;
+            x  = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+            x  = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+            x += x >> 8;
+            x += x >> 16;
+            x += x >> 32;
+            return x & 0x7f;
+        }
+    }
+
+    /// \brief  Average hash (aHash) of an image.
+    template <interleaved_pixel_concept Pix>
+    std::uint64_t ahash_view(const matrix_view<Pix> view) {
+        return detail::average_hash(view, detail::hash_bands(view, 8));
+    }
+    /// \brief  Difference hash (dHash) of an image.
+    template <interleaved_pixel_concept Pix>
+    std::uint64_t dhash_view(const matrix_view<Pix> view) {
+        return detail::difference_hash(view, detail::hash_bands(view, 8));
+    }
+    /// \brief  DCT based perceptual hash (pHash) of an image.
+    template <interleaved_pixel_concept Pix>
+    std::uint64_t phash_view(const matrix_view<Pix> view) {
+        return detail::perceptual_hash(view, detail::hash_bands(view, detail::hash_dct_size));
+    }
+    /// \brief  Hash of every image in views, images are hashed concurrently.
+    template <interleaved_pixel_concept Pix>
+    std::vector<std::uint64_t> image_hash_views(std::span<const matrix_view<Pix>> views, const image_hash kind = image_hash::perceptual) {
+        std::vector<std::uint64_t> hashes(views.size());
+        const auto bands = force::detail::band_count(views.size(), 1);
+        force::detail::for_each_band(views.size(), bands, [&](std::size_t, std::size_t beg, std::size_t end) {
+            for (auto i = beg; i != end; ++i) { hashes[i] = detail::image_hash_of(views[i], kind, 1); }
+        });
+        return hashes;
+    }
+
+    /// \brief  Number of differing bits between two hashes.
+    constexpr std::uint32_t hamming_distance(const std::uint64_t a, const std::uint64_t b) {
+        return static_cast<std::uint32_t>(std::popcount(a ^ b));
+    }
+    /// \brief  Hamming distance between query and every hash, written to out (same size as hashes).
+    inline void hamming_distances(std::span<const std::uint64_t> hashes, const std::uint64_t query, std::span<std::uint8_t> out) {
+        if (hashes.size() != out.size()) throw std::runtime_error("Hash and distance count mismatch!");
+        const auto bands = force::detail::band_count(hashes.size(), detail::hash_min_compares);
+        force::detail::for_each_band(hashes.size(), bands, [&](std::size_t, std::size_t beg, std::size_t end) {
+            // Whole chunks go through fixed size local arrays (32bit counts first, narrowing straight from 64bit
+            // doesn't vectorize) so the loops have no alias checks or remainders, the tail is done one by one.
+            std::array<std::uint32_t, detail::hash_chunk> count;
+            std::array<std::uint8_t, detail::hash_chunk>  dist;
+            const auto                                    q = query;
+            auto                                          i = beg;
+            for (; i + detail::hash_chunk <= end; i += detail::hash_chunk) {
+                const auto* h = hashes.data() + i;
+                for (std::size_t k = 0; k != detail::hash_chunk; ++k) { count[k] = static_cast<std::uint32_t>(detail::hash_popcount(h[k] ^ q)); }
+                for (std::size_t k = 0; k != detail::hash_chunk; ++k) { dist[k] = static_cast<std::uint8_t>(count[k]); }
+                std::ranges::copy(dist, out.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+            for (; i != end; ++i) { out[i] = static_cast<std::uint8_t>(hamming_distance(hashes[i], q)); }
+        });
+    }
+    /// \brief  Indices (ascending) of the hashes at most max_distance bits away from query.
+    inline std::vector<std::size_t> hamming_matches(std::span<const std::uint64_t> hashes, const std::uint64_t query, const std::uint32_t max_distance) {
+        std::vector<std::uint8_t> dist(hashes.size());
+        hamming_distances(hashes, query, dist);
+        std::vector<std::size_t> matches;
+        for (std::size_t i = 0; i != dist.size(); ++i) {
+            if (dist[i] <= max_distance) matches.push_back(i);
+        }
+        return matches;
+    }
+}
@@ -0,0 +1,197 @@
+///
+/// \file      image_algorithm_histogram.hpp
+/// \brief     Per-channel and joint histograms of interleaved images.
+/// \details
+///
+/// A naive scatter (++bin[v]) stalls whenever neighbour pixels hit the same bin because every increment
+/// has to wait for the previous store. Kernels here spread consecutive pixels over 4 sub-histograms so
+/// that 4 increments are always in flight, then rows are split into bands that run on their own
+/// threads and their histograms are merged at the end.
+///
+/// Integer pixels are binned by their top bits, floating point (HDR) pixels by a histogram_binning
+/// range that can be linear or logarithmic.
+///
+/// \author    HenryDu
+/// \date      18.10.2026
+/// \copyright © HenryDu 2026. All right reserved.
+///
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "force/execution.hpp"
+#include "force/media/image_view.hpp"
+
+namespace force::media {
+    // [channel][bin]
+    template <std::size_t Channels, std::size_t Bins = 256>
+    using image_histogram = std::array<std::array<std::size_t, Bins>, Channels>;
+
+    // Describes how floating point values are mapped to bins.
+    struct histogram_binning {
+        float32_t   min;             // Values below are put into the first bin.
+        float32_t   max;             // Values above are put into the last bin.
+        std::size_t bins;
+        bool        logarithmic;     // Bin by log2(v) between log2(min) and log2(max), min must be positive.
+    };
+
+    namespace detail {
+        // Sub-histogram counters are 32bit, so each band flushes them before they could overflow.
+        constexpr std::size_t histogram_flush_pixels = std::size_t(1) << 30;
+        constexpr std::size_t histogram_sub_count    = 4;
+        // Rows below this amount of pixels are not worth a thread.
+        constexpr std::size_t histogram_min_pixels   = 1 << 16;
+        // Bytes of per band joint tables, large colour cubes get fewer bands (down to one shared table).
+        constexpr std::size_t histogram_joint_budget = std::size_t(1) << 24;
+
+        template <std::size_t Bins, typename Ty>
+        constexpr std::size_t histogram_bin(const Ty v) {
+            constexpr auto shift = sizeof(Ty) * 8 - std::countr_zero(Bins);
+            return static_cast<std::size_t>(v) >> shift;
+        }
+
+        // Runs bin_of(value, channel) -> bin over the view and returns channels * bins counters (channel major).
+        template <typename Pix, typename BinFn>
+        std::vector<std::size_t> histogram_view_impl(const matrix_view<Pix> view, const std::size_t bins, BinFn bin_of) {
+            constexpr auto channels = pixel_channels_v<Pix>;
+            const auto     stride   = bins * channels;
+            const auto     bands    = force::detail::band_count(view.height(), histogram_min_pixels / (view.width() + 1) + 1);
+
+            std::vector<std::size_t> partial(stride * bands, 0);
+            force::detail::for_each_band(view.height(), bands, [&](std::size_t band, std::size_t beg, std::size_t end) {
+                std::vector<std::uint32_t> sub(stride * histogram_sub_count, 0);
+                std::size_t*               total   = partial.data() + band * stride;
+                std::size_t                pending = 0;
+                auto flush = [&] {
+                    for (std::size_t s = 0; s != histogram_sub_count; ++s) {
+                        for (std::size_t i = 0; i != stride; ++i) { total[i] += sub[s * stride + i]; }
+                    }
+                    std::fill(sub.begin(), sub.end(), 0);
+                    pending = 0;
+                };
+                for (auto y = beg; y != end; ++y) {
+                    if (is_flat_view(view)) {
+                        const auto*    s    = flat_row_data(view, y);
+                        constexpr auto slot = flat_channel_slots_v<Pix>;
+                        std::size_t x = 0;
+                        // Unrolled by sub-histogram count so that consecutive pixels never share a counter.
+                        for (; x + histogram_sub_count <= view.width(); x += histogram_sub_count) {
+                            for (std::size_t k = 0; k != histogram_sub_count; ++k) {
+                                auto* h = sub.data() + k * stride;
+                                for (std::size_t c = 0; c != channels; ++c) { ++h[c * bins + bin_of(s[(x + k) * channels + slot[c]], c)]; }
+                            }
+                        }
+                        for (; x != view.width(); ++x) {
+                            for (std::size_t c = 0; c != channels; ++c) { ++sub[c * bins + bin_of(s[x * channels + slot[c]], c)]; }
+                        }
+                    }
+                    else {
+                        auto row = view.row_at(y);
+                        for (std::size_t x = 0; x != view.width(); ++x) {
+                            auto* h = sub.data() + (x % histogram_sub_count) * stride;
+                            for (std::size_t c = 0; c != channels; ++c) { ++h[c * bins + bin_of(row[x][c], c)]; }
+                        }
+                    }
+                    pending += view.width();
+                    if (pending >= histogram_flush_pixels) { flush(); }
+                }
+                flush();
+            });
+            // Merge bands into the first one.
+            for (std::size_t b = 1; b < bands; ++b) {
+                for (std::size_t i = 0; i != stride; ++i) { partial[i] += partial[b * stride + i]; }
+            }
+            partial.resize(stride);
+            return partial;
+        }
+    }
+
+    /// \brief  Per-channel histogram of an integer image.
+    /// \tparam Bins - Power of two, values are binned by their top log2(Bins) bits.
+    /// \example
+    /// auto h = histogram_view(view);          // 256 bins for 8bit pixels.
+    /// auto g = histogram_view<64>(view);      // Each bin covers 4 values.
+    /// \retval      - image_histogram, h[channel][bin].
+    template <std::size_t Bins = 256, interleaved_pixel_concept Pix>
+        requires std::is_unsigned_v<typename Pix::value_type> && (std::has_single_bit(Bins)) &&
+                 (Bins <= (std::size_t(1) << (sizeof(typename Pix::value_type) * 8)))
+    image_histogram<detail::pixel_channels_v<Pix>, Bins> histogram_view(const matrix_view<Pix> view) {
+        constexpr auto channels = detail::pixel_channels_v<Pix>;
+        auto flat = detail::histogram_view_impl(view, Bins, [](const auto v, std::size_t) {
+            return detail::histogram_bin<Bins>(static_cast<typename Pix::value_type>(v));
+        });
+        image_histogram<channels, Bins> result;
+        for (std::size_t c = 0; c != channels; ++c) { std::copy_n(flat.data() + c * Bins, Bins, result[c].begin()); }
+        return result;
+    }
+    /// \brief  Per-channel histogram of a floating point (HDR) image.
+    /// \retval - result[channel][bin], binning.bins bins per channel.
+    template <interleaved_pixel_concept Pix> requires std::is_floating_point_v<typename Pix::value_type>
+    std::array<std::vector<std::size_t>, detail::pixel_channels_v<Pix>> histogram_view(const matrix_view<Pix> view, const histogram_binning binning) {
+        constexpr auto channels = detail::pixel_channels_v<Pix>;
+        if (binning.bins == 0) throw std::runtime_error("Histogram needs at least one bin!");
+        if (!(binning.max > binning.min)) throw std::runtime_error("Histogram range must have max above min!");
+        if (binning.logarithmic && !(binning.min > 0.F)) throw std::runtime_error("Logarithmic histogram range must be positive!");
+        const auto     last     = static_cast<float32_t>(binning.bins - 1);
+        const auto     lo       = binning.logarithmic ? std::log2(binning.min) : binning.min;
+        const auto     hi       = binning.logarithmic ? std::log2(binning.max) : binning.max;
+        const auto     scale    = static_cast<float32_t>(binning.bins) / (hi - lo);
+        auto flat = detail::histogram_view_impl(view, binning.bins, [=](const auto v, std::size_t) {
+            auto f = static_cast<float32_t>(v);
+            if (binning.logarithmic) { f = std::log2(f > binning.min ? f : binning.min); }
+            // Written so that NaN lands in the first bin.
+            auto b = (f - lo) * scale;
+            return static_cast<std::size_t>(b > 0.F ? (b < last ? b : last) : 0.F);
+        });
+        std::array<std::vector<std::size_t>, channels> result;
+        for (std::size_t c = 0; c != channels; ++c) { result[c].assign(flat.begin() + c * binning.bins, flat.begin() + (c + 1) * binning.bins); }
+        return result;
+    }
+    /// \brief  Joint (colour) histogram, every channel contributes its top Bits bits to a single bin index.
+    /// \tparam Bits - Bits kept per channel, result has 2^(Bits * channels) bins.
+    /// \example
+    /// auto h = joint_histogram_view<5>(bgr_view); // 32x32x32 colour cube, index = (c0 << 10) | (c1 << 5) | c2.
+    template <std::size_t Bits, interleaved_pixel_concept Pix>
+        requires std::is_unsigned_v<typename Pix::value_type> && (Bits * detail::pixel_channels_v<Pix> <= 24) &&
+                 (Bits <= sizeof(typename Pix::value_type) * 8)
+    std::vector<std::size_t> joint_histogram_view(const matrix_view<Pix> view) {
+        using value_type = typename Pix::value_type;
+        constexpr auto channels = detail::pixel_channels_v<Pix>;
+        constexpr auto shift    = sizeof(value_type) * 8 - Bits;
+        constexpr auto bins     = std::size_t(1) << (Bits * channels);
+        auto key = [](const auto& p) {
+            std::size_t k = 0;
+            for (std::size_t c = 0; c != channels; ++c) { k = (k << Bits) | (static_cast<std::size_t>(p[c]) >> shift); }
+            return k;
+        };
+        std::vector<std::size_t> result(bins, 0);
+        auto count = [&](auto* h, std::size_t beg, std::size_t end) {
+            for (auto y = beg; y != end; ++y) {
+                auto row = view.row_at(y);
+                for (std::size_t x = 0; x != view.width(); ++x) { ++h[key(row[x])]; }
+            }
+        };
+        // The joint table is large and sparse, conflicts between neighbours are rare so one table per band is enough.
+        // Band tables are 32bit and their total size is capped, a single band counts straight into the result.
+        const auto pixels = view.width() * view.height();
+        const auto bands  = pixels >= detail::histogram_flush_pixels ? 1 :
+            std::min(force::detail::band_count(view.height(), detail::histogram_min_pixels / (view.width() + 1) + 1),
+                     detail::histogram_joint_budget / (bins * sizeof(std::uint32_t)));
+        if (bands <= 1) {
+            count(result.data(), 0, view.height());
+            return result;
+        }
+        std::vector<std::uint32_t> partial(bins * bands, 0);
+        force::detail::for_each_band(view.height(), bands, [&](std::size_t band, std::size_t beg, std::size_t end) {
+            count(partial.data() + band * bins, beg, end);
+        });
+        for (std::size_t b = 0; b != bands; ++b) {
+            for (std::size_t i = 0; i != bins; ++i) { result[i] += partial[b * bins + i]; }
+        }
+        return result;
+    }
+}
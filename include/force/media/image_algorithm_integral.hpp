@@ -0,0 +1,151 @@
+///
+/// \file      image_algorithm_integral.hpp
+/// \brief     Summed-area tables (integral images) and O(1) rectangle sums.
+/// \details
+///
+/// An integral image has one more row and column than its source. Entry (x, y) holds the per-channel
+/// sum of every source pixel above and to the left of it, and row 0 and column 0 are zero, so the sum
+/// over any rectangle takes four reads.
+///
+/// Accumulators are widened: 8 and 16 bit unsigned sums use 32 bits, other integers use 64 bits,
+/// floating point uses double. Unsigned sums wrap, but the four-corner difference is still exact as
+/// long as the rectangle's own sum fits, so 32 bits covers every 8bit rectangle of up to 16M pixels.
+/// Squared tables always use 64 bits (or double).
+///
+/// Construction takes two passes. First every row is prefix-summed on its own, split into row bands.
+/// Then rows are accumulated downwards, split into column strips whose edges are cache line aligned
+/// so that two threads never write the same line.
+///
+/// \author    HenryDu
+/// \date      18.10.2026
+/// \copyright © HenryDu 2026. All right reserved.
+///
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "force/execution.hpp"
+#include "force/media/image_view.hpp"
+
+namespace force::media {
+    // Accumulator of a plain integral image over values of type Ty.
+    template <typename Ty>
+    using integral_value_t = std::conditional_t<std::is_floating_point_v<Ty>, float64_t,
+                             std::conditional_t<std::is_signed_v<Ty>, std::int64_t,
+                             std::conditional_t<(sizeof(Ty) <= 2), std::uint32_t, std::uint64_t>>>;
+    // Accumulator of a squared integral image over values of type Ty.
+    template <typename Ty>
+    using squared_integral_value_t = std::conditional_t<std::is_floating_point_v<Ty>, float64_t, std::uint64_t>;
+
+    template <typename Acc, std::size_t Channels>
+    class integral_image {
+    public:
+        using value_type = Acc;
+        using sum_type   = std::array<Acc, Channels>;
+
+        integral_image() = default;
+        integral_image(std::size_t w, std::size_t h) : mData((w + 1) * (h + 1) * Channels, Acc(0)), mWidth(w), mHeight(h) {}
+
+        // Size of the source image, the table itself is (width + 1) x (height + 1).
+        constexpr std::size_t width()    const { return mWidth; }
+        constexpr std::size_t height()   const { return mHeight; }
+        constexpr std::size_t stride()   const { return (mWidth + 1) * Channels; }
+        constexpr std::size_t channels() const { return Channels; }
+
+        Acc*       row(std::size_t y)       { return mData.data() + y * stride(); }
+        const Acc* row(std::size_t y) const { return mData.data() + y * stride(); }
+        Acc        at(std::size_t x, std::size_t y, std::size_t c) const { return row(y)[x * Channels + c]; }
+
+        /// \brief Sum of channel c over the w x h rectangle whose top left source pixel is (x, y).
+        Acc rect_sum(std::size_t x, std::size_t y, std::size_t w, std::size_t h, std::size_t c) const {
+            const Acc* top    = row(y);
+            const Acc* bottom = row(y + h);
+            return (bottom[(x + w) * Channels + c] - bottom[x * Channels + c]) - (top[(x + w) * Channels + c] - top[x * Channels + c]);
+        }
+        sum_type rect_sum(std::size_t x, std::size_t y, std::size_t w, std::size_t h) const {
+            sum_type s;
+            for (std::size_t c = 0; c != Channels; ++c) { s[c] = rect_sum(x, y, w, h, c); }
+            return s;
+        }
+
+        ~integral_image() = default;
+    private:
+        std::vector<Acc> mData;
+        std::size_t      mWidth = 0, mHeight = 0;
+    };
+
+    namespace detail {
+        constexpr std::size_t integral_min_pixels = 1 << 16;
+
+        template <typename Acc, typename Pix, typename Fn>
+        integral_image<Acc, pixel_channels_v<Pix>> build_integral(const matrix_view<Pix> view, Fn f) {
+            using value_t = typename Pix::value_type;
+            constexpr auto channels = pixel_channels_v<Pix>;
+            integral_image<Acc, channels> table(view.width(), view.height());
+            const auto w = view.width(), h = view.height();
+            if (w == 0 || h == 0) return table;
+
+            // Row prefix sums, row y of the source goes to row y + 1 of the table.
+            auto bands = force::detail::band_count(h, integral_min_pixels / w + 1);
+            force::detail::for_each_band(h, bands, [&](std::size_t, std::size_t beg, std::size_t end) {
+                for (auto y = beg; y != end; ++y) {
+                    Acc* d = table.row(y + 1) + channels;
+                    Acc  run[channels] = {};
+                    if (is_flat_view(view)) {
+                        const value_t* s    = flat_row_data(view, static_cast<std::ptrdiff_t>(y));
+                        constexpr auto slot = flat_channel_slots_v<Pix>;
+                        for (std::size_t x = 0; x != w; ++x) {
+                            for (std::size_t c = 0; c != channels; ++c) { d[x * channels + c] = run[c] += f(s[x * channels + slot[c]]); }
+                        }
+                        continue;
+                    }
+                    auto row = view.row_at(static_cast<std::ptrdiff_t>(y));
+                    for (std::size_t x = 0; x != w; ++x) {
+                        const Pix& p = row[x];
+                        for (std::size_t c = 0; c != channels; ++c) { d[x * channels + c] = run[c] += f(static_cast<value_t>(p[c])); }
+                    }
+                }
+            });
+            // Column pass, every strip walks all rows and adds the row above (vectorizes across the strip).
+            const auto stride = table.stride();
+            const auto line   = std::max<std::size_t>(1, force::detail::cache_line_bytes / sizeof(Acc));
+            const auto lines  = (stride + line - 1) / line;
+            bands = force::detail::band_count(lines, integral_min_pixels / (h * line) + 1);
+            force::detail::for_each_band(lines, bands, [&](std::size_t, std::size_t beg, std::size_t end) {
+                const auto x0 = beg * line, x1 = std::min(end * line, stride);
+                for (std::size_t y = 2; y <= h; ++y) {
+                    const Acc* above = table.row(y - 1);
+                    Acc*       d     = table.row(y);
+                    for (auto i = x0; i != x1; ++i) { d[i] += above[i]; }
+                }
+            });
+            return table;
+        }
+    }
+
+    /// \brief  Integral image of view, per channel.
+    /// \example
+    /// auto sum  = integral_view(grey);
+    /// auto mean = sum.rect_sum(x, y, 15, 15, 0) / 225;
+    template <interleaved_pixel_concept Pix>
+    decltype(auto) integral_view(const matrix_view<Pix> view) {
+        using acc_t = integral_value_t<typename Pix::value_type>;
+        return detail::build_integral<acc_t>(view, [](const auto v) { return static_cast<acc_t>(v); });
+    }
+    /// \brief  Integral image of the squared channel values of view.
+    template <interleaved_pixel_concept Pix>
+    decltype(auto) squared_integral_view(const matrix_view<Pix> view) {
+        using acc_t = squared_integral_value_t<typename Pix::value_type>;
+        return detail::build_integral<acc_t>(view, [](const auto v) { return static_cast<acc_t>(v) * static_cast<acc_t>(v); });
+    }
+    /// \brief  Mean and variance of channel c over a rectangle, from an integral and a squared integral image of the same view.
+    template <typename Acc1, typename Acc2, std::size_t Channels>
+    std::pair<float64_t, float64_t> integral_rect_statistics(const integral_image<Acc1, Channels>& sum, const integral_image<Acc2, Channels>& squared,
+                                                             std::size_t x, std::size_t y, std::size_t w, std::size_t h, std::size_t c) {
+        const auto n    = static_cast<float64_t>(w * h);
+        const auto mean = static_cast<float64_t>(sum.rect_sum(x, y, w, h, c)) / n;
+        const auto sq   = static_cast<float64_t>(squared.rect_sum(x, y, w, h, c)) / n;
+        return std::make_pair(mean, std::max(0.0, sq - mean * mean));
+    }
+}
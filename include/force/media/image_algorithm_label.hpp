@@ -0,0 +1,314 @@
+///
+/// \file      image_algorithm_label.hpp
+/// \brief     Connected component labeling of binary masks with per component statistics.
+/// \details
+///
+/// A pixel is foreground when its channel is not zero. Components get labels 1 to n in the raster
+/// order of their first pixel (first 2x2 block for 8-connectivity), background is 0. Labeling never
+/// recurses, so image size doesn't matter for the stack.
+///
+/// The work runs in two passes over row strips on the shared thread pool:
+/// - The first pass hands out provisional labels and records equivalences in a union-find forest.
+///   Links always point to the smaller label and finds halve their path. Every strip owns a label
+///   range, so strips don't share any state. 8-connectivity scans 2x2 blocks (Grana et al. 2010):
+///   all foreground pixels of a block touch each other, so one label covers the block and only four
+///   neighbouring blocks need testing, each with a couple of pixel checks. 4-connectivity scans
+///   runs of foreground pixels, which link once to every run above them. Background is skipped a
+///   word of flags at a time.
+/// - Equivalences across strip edges are merged serially, then the forest is flattened into final
+///   labels. The second pass writes the label map and gathers area, bounding box and coordinate sums
+///   per provisional label, which are finally summed per component.
+///
+/// \author    HenryDu
+/// \date      18.10.2026
+/// \copyright © HenryDu 2026. All right reserved.
+///
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "force/execution.hpp"
+#include "force/media/image_view.hpp"
+
+namespace force::media {
+    enum class connectivity {
+        four,  // Edge neighbours only.
+        eight  // Edge and corner neighbours.
+    };
+
+    struct component_stats {
+        std::size_t area   = 0;
+        // Inclusive bounding box.
+        std::size_t left   = 0, top    = 0;
+        std::size_t right  = 0, bottom = 0;
+        float64_t   centroid_x = 0.0, centroid_y = 0.0;
+    };
+
+    namespace detail {
+        constexpr std::size_t label_min_pixels = 1 << 16;
+
+        // Union-find over provisional labels, 0 is the background and always its own root.
+        class label_forest {
+        public:
+            explicit label_forest(std::size_t n) : mParent(std::make_unique_for_overwrite<std::uint32_t[]>(n + 1)) { mParent[0] = 0; }
+
+            std::uint32_t make(std::uint32_t l)  { mParent[l] = l; return l; }
+            std::uint32_t find(std::uint32_t l)  {
+                while (mParent[l] != l) {
+                    mParent[l] = mParent[mParent[l]];
+                    l = mParent[l];
+                }
+                return l;
+            }
+            // Join the sets of a and b, the smaller root becomes the root of both.
+            std::uint32_t merge(std::uint32_t a, std::uint32_t b) {
+                if (a == b) return a;
+                a = find(a);
+                b = find(b);
+                if (a == b) return a;
+                if (a > b) std::swap(a, b);
+                mParent[b] = a;
+                return a;
+            }
+            std::uint32_t& operator[](std::size_t l) { return mParent[l]; }
+        private:
+            std::unique_ptr<std::uint32_t[]> mParent;
+        };
+
+        // Flag rows keep a zero in front and a word of zeros behind the pixels, so neighbour tests need
+        // no bounds checks and background can be skipped a word at a time.
+        constexpr std::size_t label_row_size(std::size_t w) { return w + 2 + sizeof(std::uint64_t); }
+
+        // Row y of a single channel mask as 0 / 1 flags at out[1, w], the padding stays 0.
+        template <typename Pix>
+        void load_label_row(const matrix_view<Pix>& mask, const std::ptrdiff_t y, std::vector<std::uint8_t>& out) {
+            std::fill(out.begin(), out.end(), 0);
+            if (y < 0 || y >= static_cast<std::ptrdiff_t>(mask.height())) return;
+            read_channel_row(mask, y, out.data() + 1, [](const auto v) { return static_cast<std::uint8_t>(v != 0); });
+        }
+        // First x in [x, end) with a non zero flag, or end.
+        inline std::size_t skip_label_background(const std::uint8_t* flags, std::size_t x, const std::size_t end) {
+            for (std::uint64_t word = 0; x < end; x += sizeof(word)) {
+                std::memcpy(&word, flags + x, sizeof(word));
+                if (word != 0) break;
+            }
+            while (x < end && flags[x] == 0) ++x;
+            return std::min(x, end);
+        }
+
+        struct label_accumulator {
+            std::uint64_t area = 0, sum_x = 0, sum_y = 0;
+            std::uint32_t left = std::numeric_limits<std::uint32_t>::max(), top = std::numeric_limits<std::uint32_t>::max(), right = 0, bottom = 0;
+
+            // Add the run of pixels [x0, x1] in row y.
+            void add(const std::uint32_t x0, const std::uint32_t x1, const std::uint32_t y) {
+                const std::uint64_t n = x1 - x0 + 1;
+                area += n; sum_x += (std::uint64_t(x0) + x1) * n / 2; sum_y += std::uint64_t(y) * n;
+                left = std::min(left, x0); right = std::max(right, x1);
+                top  = std::min(top, y);   bottom = std::max(bottom, y);
+            }
+            void add(const label_accumulator& o) {
+                area += o.area; sum_x += o.sum_x; sum_y += o.sum_y;
+                left = std::min(left, o.left); right = std::max(right, o.right);
+                top  = std::min(top, o.top);   bottom = std::max(bottom, o.bottom);
+            }
+        };
+
+        // Provisional labels of one strip, [base, base + count) belong to it.
+        struct label_strip {
+            std::size_t                    beg = 0, end = 0;
+            std::uint32_t                  base = 0, count = 0;
+            std::vector<label_accumulator> stats;
+        };
+
+        // The grid the first pass labels: 2x2 blocks for 8-connectivity, pixels for 4-connectivity. Pixel
+        // labels go straight into the label map when its rows are contiguous, the second pass then
+        // rewrites them in place.
+        struct label_grid {
+            std::size_t                      width, height, shift; // Cells are 1 << shift pixels wide and high.
+            std::unique_ptr<std::uint32_t[]> storage;
+            std::uint32_t*                   cells;
+            std::ptrdiff_t                   stride;
+
+            label_grid(matrix_view<std::uint32_t>& labels, std::size_t s) : width(((labels.width() - 1) >> s) + 1), height(((labels.height() - 1) >> s) + 1), shift(s) {
+                if (s == 0 && labels.col_delta() == 1) {
+                    cells  = labels.data();
+                    stride = labels.row_delta();
+                }
+                else {
+                    storage = std::make_unique_for_overwrite<std::uint32_t[]>(width * height);
+                    cells   = storage.get();
+                    stride  = static_cast<std::ptrdiff_t>(width);
+                }
+            }
+            std::uint32_t* row(std::size_t y) { return cells + static_cast<std::ptrdiff_t>(y) * stride; }
+            // A new pixel label needs a background pixel to its left, so at most every second pixel of a
+            // row starts one. Blocks have no such bound, 1 0 1 0 gives two unconnected blocks.
+            std::size_t    labels_per_row() const { return shift == 0 ? (width + 1) / 2 : width; }
+        };
+
+        // First pass over 2x2 blocks. With a b / c d the block's pixels, the neighbours are the blocks
+        // up left (P), up (Q), up right (R) and left (S).
+        template <typename Pix>
+        void label_blocks(const matrix_view<Pix>& mask, label_grid& grid, label_forest& forest, label_strip& strip) {
+            const auto bw = grid.width;
+            const auto n  = label_row_size(2 * bw);
+            std::vector<std::uint8_t> above(n), r0(n), r1(n), any(n);
+            auto next = strip.base;
+            for (auto by = strip.beg; by != strip.end; ++by) {
+                const auto y = static_cast<std::ptrdiff_t>(2 * by);
+                // The strip's first row doesn't look up, the merge pass links it.
+                load_label_row(mask, by != strip.beg ? y - 1 : -1, above);
+                load_label_row(mask, y, r0);
+                load_label_row(mask, y + 1, r1);
+                for (std::size_t i = 0; i != n; ++i) { any[i] = r0[i] | r1[i]; }
+                const std::uint32_t* up  = grid.row(by - (by != strip.beg));
+                std::uint32_t*       cur = grid.row(by);
+                for (std::size_t bx = 0; bx != bw; ++bx) {
+                    const auto skip = skip_label_background(any.data() + 1, 2 * bx, 2 * bw) / 2;
+                    std::fill(cur + bx, cur + skip, 0);
+                    if ((bx = skip) == bw) break;
+                    // Pixel x of the image is at index x + 1 of the flag rows.
+                    const auto x = 2 * bx + 1;
+                    const bool a = r0[x], b = r0[x + 1], c = r1[x];
+                    std::uint32_t l = 0;
+                    auto link = [&](const std::uint32_t o) { l = l == 0 ? o : forest.merge(l, o); };
+                    if ((a | c) & any[x - 1])                 link(cur[bx - 1]);
+                    if ((a | b) & (above[x] | above[x + 1]))  link(up[bx]);
+                    if (a & above[x - 1])                     link(up[bx - 1]);
+                    if (b & above[x + 2])                     link(up[bx + 1]);
+                    cur[bx] = l != 0 ? l : forest.make(next++);
+                }
+            }
+            strip.count = next - strip.base;
+        }
+        // First pass over pixels. A run of foreground shares one label and links to every run above it,
+        // consecutive pixels above belong to one run and need a single link.
+        template <typename Pix>
+        void label_pixels(const matrix_view<Pix>& mask, label_grid& grid, label_forest& forest, label_strip& strip) {
+            const auto w = grid.width;
+            std::vector<std::uint8_t> above(label_row_size(w)), row(label_row_size(w));
+            auto next = strip.base;
+            for (auto y = strip.beg; y != strip.end; ++y) {
+                load_label_row(mask, y != strip.beg ? static_cast<std::ptrdiff_t>(y) - 1 : -1, above);
+                load_label_row(mask, static_cast<std::ptrdiff_t>(y), row);
+                const std::uint8_t*  f   = row.data() + 1;
+                const std::uint8_t*  a   = above.data() + 1;
+                const std::uint32_t* up  = grid.row(y - (y != strip.beg));
+                std::uint32_t*       cur = grid.row(y);
+                for (std::size_t x = 0; x != w;) {
+                    const auto x0 = skip_label_background(f, x, w);
+                    std::fill(cur + x, cur + x0, 0);
+                    if ((x = x0) == w) break;
+                    std::uint32_t l = 0;
+                    for (; x != w && f[x]; ++x) {
+                        if (a[x] & ((x == x0) | !a[x - 1])) l = l == 0 ? up[x] : forest.merge(l, up[x]);
+                    }
+                    std::fill(cur + x0, cur + x, l != 0 ? l : forest.make(next++));
+                }
+            }
+            strip.count = next - strip.base;
+        }
+        // Merge the first row of a strip with the last row of the strip above it.
+        template <typename Pix>
+        void merge_label_strips(const matrix_view<Pix>& mask, label_grid& grid, label_forest& forest, const std::size_t edge) {
+            const auto n = label_row_size(grid.width << grid.shift);
+            std::vector<std::uint8_t> above(n), r0(n);
+            load_label_row(mask, static_cast<std::ptrdiff_t>(edge << grid.shift) - 1, above);
+            load_label_row(mask, static_cast<std::ptrdiff_t>(edge << grid.shift), r0);
+            const std::uint32_t* up  = grid.row(edge - 1);
+            const std::uint32_t* cur = grid.row(edge);
+            if (grid.shift == 0) {
+                for (std::size_t x = 0; x != grid.width; ++x) {
+                    if (r0[x + 1] & above[x + 1]) forest.merge(cur[x], up[x]);
+                }
+                return;
+            }
+            for (std::size_t bx = 0; bx != grid.width; ++bx) {
+                const auto x = 2 * bx + 1;
+                const bool a = r0[x], b = r0[x + 1];
+                if ((a | b) & (above[x] | above[x + 1])) forest.merge(cur[bx], up[bx]);
+                if (a & above[x - 1])                    forest.merge(cur[bx], up[bx - 1]);
+                if (b & above[x + 2])                    forest.merge(cur[bx], up[bx + 1]);
+            }
+        }
+    }
+
+    /// \brief  Label the connected components of a single channel mask into labels (same size), background is 0.
+    /// \retval Statistics of every component, element i describes label i + 1.
+    /// \example
+    /// std::vector<std::uint32_t> ids(w * h);
+    /// auto blobs = label_components_view(mask, matrix_view<std::uint32_t>(ids.data(), 0, 0, w, h, w));
+    /// for (auto& b : blobs) { if (b.area < 20) continue; ... }
+    template <interleaved_pixel_concept Pix>
+    std::vector<component_stats> label_components_view(const matrix_view<Pix> mask, matrix_view<std::uint32_t> labels,
+                                                       const connectivity conn = connectivity::eight) {
+        static_assert(detail::pixel_channels_v<Pix> == 1, "Masks have a single channel!");
+        if (mask.width() != labels.width() || mask.height() != labels.height()) throw std::runtime_error("Mask and label map size mismatch!");
+        if (mask.size() >= std::numeric_limits<std::uint32_t>::max()) throw std::runtime_error("Mask is too large for 32bit labels!");
+        if (mask.width() == 0 || mask.height() == 0) return {};
+        const auto w = mask.width(), h = mask.height();
+        detail::label_grid   grid(labels, conn == connectivity::eight ? 1 : 0);
+        const auto shift = grid.shift;
+        detail::label_forest forest(grid.labels_per_row() * grid.height);
+        const auto bands = force::detail::band_count(grid.height, detail::label_min_pixels / (w << shift) + 1);
+        std::vector<detail::label_strip> strips(bands);
+        force::detail::for_each_band(grid.height, bands, [&](std::size_t band, std::size_t beg, std::size_t end) {
+            auto& s = strips[band];
+            s.beg  = beg;
+            s.end  = end;
+            s.base = static_cast<std::uint32_t>(beg * grid.labels_per_row() + 1);
+            if (conn == connectivity::eight) detail::label_blocks(mask, grid, forest, s);
+            else                             detail::label_pixels(mask, grid, forest, s);
+        });
+        for (const auto& s : strips) {
+            if (s.beg != 0 && s.beg < s.end) detail::merge_label_strips(mask, grid, forest, s.beg);
+        }
+        // Parents are always smaller than their children and strips are in raster order, so a parent
+        // already holds its final label when its children are visited and labels come out in raster order.
+        std::uint32_t n = 0;
+        for (const auto& s : strips) {
+            for (auto l = s.base; l != s.base + s.count; ++l) { forest[l] = forest[l] == l ? ++n : forest[forest[l]]; }
+        }
+        // forest[l] is now the final label of provisional label l.
+        force::detail::for_each_band(grid.height, bands, [&](std::size_t band, std::size_t beg, std::size_t end) {
+            auto& s = strips[band];
+            s.stats.resize(s.count);
+            std::vector<std::uint8_t> flags(detail::label_row_size(grid.width << shift));
+            const auto cd = labels.col_delta();
+            for (auto y = beg << shift; y < std::min(end << shift, h); ++y) {
+                detail::load_label_row(mask, static_cast<std::ptrdiff_t>(y), flags);
+                const std::uint8_t*  f    = flags.data() + 1;
+                const std::uint32_t* prov = grid.row(y >> shift);
+                std::uint32_t*       d    = labels.data() + static_cast<std::ptrdiff_t>(y) * labels.row_delta();
+                // Walk runs of pixels sharing a provisional label, so the statistics are updated once per run.
+                for (std::size_t x = 0; x != w;) {
+                    for (const auto x0 = detail::skip_label_background(f, x, w); x != x0; ++x) { d[static_cast<std::ptrdiff_t>(x) * cd] = 0; }
+                    if (x == w) break;
+                    const auto p  = prov[x >> shift];
+                    const auto l  = forest[p];
+                    const auto x0 = x;
+                    for (; x != w && f[x] && prov[x >> shift] == p; ++x) { d[static_cast<std::ptrdiff_t>(x) * cd] = l; }
+                    s.stats[p - s.base].add(static_cast<std::uint32_t>(x0), static_cast<std::uint32_t>(x - 1), static_cast<std::uint32_t>(y));
+                }
+            }
+        });
+        std::vector<detail::label_accumulator> sums(n);
+        for (const auto& s : strips) {
+            for (std::uint32_t i = 0; i != s.count; ++i) { sums[forest[s.base + i] - 1].add(s.stats[i]); }
+        }
+        std::vector<component_stats> stats(n);
+        for (std::size_t i = 0; i != n; ++i) {
+            const auto& a = sums[i];
+            stats[i] = { static_cast<std::size_t>(a.area), a.left, a.top, a.right, a.bottom,
+                         static_cast<float64_t>(a.sum_x) / static_cast<float64_t>(a.area), static_cast<float64_t>(a.sum_y) / static_cast<float64_t>(a.area) };
+        }
+        return stats;
+    }
+}
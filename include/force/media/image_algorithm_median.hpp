@@ -0,0 +1,311 @@
+///
+/// \file      image_algorithm_median.hpp
+/// \brief     Median filter over 8bit channels in constant time per pixel.
+/// \details
+///
+/// Every channel is filtered on its own over a (2r + 1) x (2r + 1) square. Pixels outside the image
+/// come from a border_policy. The source is first copied into a padded buffer, so src may alias dest.
+///
+/// - r = 1 and r = 2 use a sorting network: Batcher's odd-even merge sort cut down to the comparisons
+///   the middle output depends on. It runs on whole runs of a row at once, so each comparison
+///   is a min/max over a short array and vectorizes.
+/// - Larger r use Perreault and Hébert's histogram method (2007). Every column keeps a 256 bin
+///   histogram of the 2r + 1 values above and below the current row, and moving one row down
+///   removes one value and adds one. The window histogram slides right by adding one column
+///   histogram and subtracting another. Histograms are split into 16 coarse bins and 16 x 16 fine
+///   bins, and a fine segment is only brought up to date when the median falls in it. So the work
+///   per pixel doesn't depend on r.
+///
+/// The histogram path works on column strips whose histograms fit in the L2 cache. Strips run on
+/// the shared thread pool, and the networks run in row bands.
+///
+/// \author    HenryDu
+/// \date      18.10.2026
+/// \copyright © HenryDu 2026. All right reserved.
+///
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "force/execution.hpp"
+#include "force/media/image_algorithm_convolution.hpp"
+
+namespace force::media {
+    namespace detail {
+        constexpr std::size_t median_min_elements = 1 << 15;
+        // Row elements every network step works on at once.
+        constexpr std::size_t median_network_lanes = 128;
+
+        // One step of a selection network: lo = min(lo, hi) and hi = max(lo, hi), or only one of them.
+        struct median_exchange {
+            enum kind_t : std::uint8_t { both, min_only, max_only };
+            std::uint8_t lo, hi;
+            kind_t       kind;
+        };
+        struct median_network {
+            std::array<median_exchange, 256> steps{};
+            std::size_t                      size = 0;
+        };
+        /// \brief  Steps that leave the median of N inputs in wire N / 2. Batcher's odd-even merge sort over the
+        ///         next power of two, comparisons with wires past N dropped (they act as +inf and never swap),
+        ///         then everything the middle wire doesn't depend on removed.
+        template <std::size_t N>
+        constexpr median_network make_median_network() {
+            std::size_t p2 = 1;
+            while (p2 < N) { p2 <<= 1; }
+            median_network sort;
+            for (std::size_t p = 1; p < p2; p <<= 1) {
+                for (std::size_t k = p; k >= 1; k >>= 1) {
+                    for (std::size_t j = k % p; j + k < p2; j += 2 * k) {
+                        for (std::size_t i = 0; i < k && i + j + k < p2; ++i) {
+                            if ((i + j) / (2 * p) != (i + j + k) / (2 * p)) continue;
+                            if (i + j + k >= N) continue;
+                            sort.steps[sort.size++] = { static_cast<std::uint8_t>(i + j), static_cast<std::uint8_t>(i + j + k), median_exchange::both };
+                        }
+                    }
+                }
+            }
+            // Walk backwards keeping only steps whose outputs are still needed.
+            std::array<bool, N> needed{};
+            needed[N / 2] = true;
+            median_network kept;
+            std::array<median_exchange, 256> reversed{};
+            for (auto s = sort.size; s-- != 0;) {
+                auto e = sort.steps[s];
+                if (!needed[e.lo] && !needed[e.hi]) continue;
+                e.kind = needed[e.lo] && needed[e.hi] ? median_exchange::both : needed[e.lo] ? median_exchange::min_only : median_exchange::max_only;
+                needed[e.lo] = needed[e.hi] = true;
+                reversed[kept.size++] = e;
+            }
+            for (std::size_t s = 0; s != kept.size; ++s) { kept.steps[s] = reversed[kept.size - 1 - s]; }
+            return kept;
+        }
+        template <std::size_t N>
+        constexpr auto median_network_v = make_median_network<N>();
+
+        // Interleaved 8bit channels with pad_x pixels of border left and right and pad_y rows above and below,
+        // rows are packed.
+        struct median_buffer {
+            std::vector<std::uint8_t> data;
+            std::size_t               width, height, channels, pad_x, pad_y;
+
+            median_buffer(std::size_t w, std::size_t h, std::size_t c, std::size_t px, std::size_t py)
+                : data((w + 2 * px) * (h + 2 * py) * c), width(w), height(h), channels(c), pad_x(px), pad_y(py) {}
+            std::size_t         stride()                const { return (width + 2 * pad_x) * channels; }
+            // Row y of the image, -pad_y <= y < height + pad_y. Element 0 is channel 0 of pixel x = 0.
+            std::uint8_t*       row(std::ptrdiff_t y)         { return data.data() + (y + static_cast<std::ptrdiff_t>(pad_y)) * stride() + pad_x * channels; }
+            const std::uint8_t* row(std::ptrdiff_t y)   const { return data.data() + (y + static_cast<std::ptrdiff_t>(pad_y)) * stride() + pad_x * channels; }
+        };
+
+        template <typename Pix>
+        median_buffer load_median_buffer(const matrix_view<Pix> view, const std::size_t pad_x, const std::size_t pad_y, const border_policy border) {
+            constexpr auto channels = pixel_channels_v<Pix>;
+            const auto     w        = static_cast<std::ptrdiff_t>(view.width());
+            const auto     h        = static_cast<std::ptrdiff_t>(view.height());
+            const auto     p        = static_cast<std::ptrdiff_t>(pad_x);
+            median_buffer buf(view.width(), view.height(), channels, pad_x, pad_y);
+            const auto rows  = view.height() + 2 * pad_y;
+            const auto bands = force::detail::band_count(rows, median_min_elements / (buf.stride() + 1) + 1);
+            force::detail::for_each_band(rows, bands, [&](std::size_t, std::size_t beg, std::size_t end) {
+                for (auto r = beg; r != end; ++r) {
+                    const auto y = static_cast<std::ptrdiff_t>(r) - static_cast<std::ptrdiff_t>(pad_y);
+                    std::uint8_t* d = buf.row(y);
+                    read_channel_row(view, border_index(y, h, border), d, std::identity{});
+                    for (std::ptrdiff_t x = -p; x != 0; ++x) { std::copy_n(d + border_index(x, w, border) * channels, channels, d + x * channels); }
+                    for (std::ptrdiff_t x = w; x != w + p; ++x) { std::copy_n(d + border_index(x, w, border) * channels, channels, d + x * channels); }
+                }
+            });
+            return buf;
+        }
+
+        // Median over (2R + 1)^2 windows with a selection network, out gets height rows of width * channels.
+        template <std::size_t R>
+        void median_by_network(const median_buffer& in, std::vector<std::uint8_t>& out) {
+            constexpr std::size_t n       = (2 * R + 1) * (2 * R + 1);
+            constexpr auto&       network = median_network_v<n>;
+            const auto c      = static_cast<std::ptrdiff_t>(in.channels);
+            const auto stride = in.width * in.channels;
+            const auto bands  = force::detail::band_count(in.height, median_min_elements / (stride * n + 1) + 1);
+            force::detail::for_each_band(in.height, bands, [&](std::size_t, std::size_t beg, std::size_t end) {
+                std::vector<std::uint8_t>                      wires(n * median_network_lanes);
+                std::array<std::uint8_t, median_network_lanes> a, b;
+                for (auto y = beg; y != end; ++y) {
+                    std::uint8_t* d = out.data() + y * stride;
+                    for (std::size_t i0 = 0; i0 < stride; i0 += median_network_lanes) {
+                        const auto lanes = std::min(median_network_lanes, stride - i0);
+                        // Wire k holds window element k for every lane.
+                        std::size_t k = 0;
+                        for (std::ptrdiff_t dy = -static_cast<std::ptrdiff_t>(R); dy <= static_cast<std::ptrdiff_t>(R); ++dy) {
+                            const std::uint8_t* s = in.row(static_cast<std::ptrdiff_t>(y) + dy) + i0;
+                            for (std::ptrdiff_t dx = -static_cast<std::ptrdiff_t>(R); dx <= static_cast<std::ptrdiff_t>(R); ++dx, ++k) {
+                                std::copy_n(s + dx * c, lanes, wires.data() + k * median_network_lanes);
+                            }
+                        }
+                        for (std::size_t s = 0; s != network.size; ++s) {
+                            const auto&   e  = network.steps[s];
+                            std::uint8_t* lo = wires.data() + e.lo * median_network_lanes;
+                            std::uint8_t* hi = wires.data() + e.hi * median_network_lanes;
+                            // Both wires are copied out first so the compiler can tell the loops below never overlap
+                            // (and they always run all lanes, a constant trip count is what lets them vectorize).
+                            std::copy_n(lo, median_network_lanes, a.data());
+                            std::copy_n(hi, median_network_lanes, b.data());
+                            if (e.kind != median_exchange::max_only) {
+                                for (std::size_t l = 0; l != median_network_lanes; ++l) { lo[l] = std::min(a[l], b[l]); }
+                            }
+                            if (e.kind != median_exchange::min_only) {
+                                for (std::size_t l = 0; l != median_network_lanes; ++l) { hi[l] = std::max(a[l], b[l]); }
+                            }
+                        }
+                        std::copy_n(wires.data() + (n / 2) * median_network_lanes, lanes, d + i0);
+                    }
+                }
+            });
+        }
+
+        // Median over (2r + 1)^2 windows with sliding coarse/fine histograms, column strip by column strip.
+        // Rows outside the image and columns past the buffer's pad are looked up through the border policy.
+        inline void median_by_histogram(const median_buffer& in, const std::size_t r, const border_policy border, std::vector<std::uint8_t>& out) {
+            constexpr std::size_t coarse = 16, fine = 256;
+            const auto c      = in.channels;
+            const auto w      = in.width, h = in.height;
+            const auto stride = w * c;
+            const auto span   = 2 * r + 1;
+            const auto rank   = static_cast<std::uint32_t>(span * span / 2);
+            // Output columns per strip: column histograms of a strip should stay in L2, but a strip shouldn't be
+            // much narrower than the window or most of the work goes into columns only read by a few pixels.
+            const auto per_column = c * (coarse + fine) * sizeof(std::uint16_t);
+            auto strip = force::detail::cache_sizes().l2 / 2 / per_column;
+            strip = std::max({ strip > span ? strip - span : 0, 2 * r, std::size_t(32) });
+            strip = std::min(strip, std::max<std::size_t>(2 * r, (w + default_thread_pool().concurrency() - 1) / default_thread_pool().concurrency()));
+            strip = std::max<std::size_t>(1, std::min(strip, w));
+            const auto strips = (w + strip - 1) / strip;
+            const auto bands  = force::detail::band_count(strips, median_min_elements / (strip * h * c + 1) + 1);
+
+            force::detail::for_each_band(strips, bands, [&](std::size_t, std::size_t beg, std::size_t end) {
+                std::vector<std::uint16_t> col_coarse, col_fine;
+                std::vector<std::uint32_t> ker_coarse(c * coarse), ker_fine(c * fine);
+                std::vector<std::ptrdiff_t> ker_last(c * coarse);
+                for (auto s = beg; s != end; ++s) {
+                    const auto x0   = s * strip, x1 = std::min(w, x0 + strip);
+                    const auto cols = x1 - x0 + 2 * r;
+                    // Histogram of padded column j (image column x0 - r + j), channel ch.
+                    col_coarse.assign(cols * c * coarse, 0);
+                    col_fine.assign(cols * c * fine, 0);
+                    auto coarse_of = [&](std::size_t j, std::size_t ch) { return col_coarse.data() + (j * c + ch) * coarse; };
+                    auto fine_of   = [&](std::size_t j, std::size_t ch) { return col_fine.data() + (j * c + ch) * fine; };
+                    // Padded columns [lo, hi) are inside the buffer, the rest map back into the image.
+                    const auto first = static_cast<std::ptrdiff_t>(x0) - static_cast<std::ptrdiff_t>(r);
+                    const auto lo    = static_cast<std::size_t>(std::max<std::ptrdiff_t>(0, -static_cast<std::ptrdiff_t>(in.pad_x) - first));
+                    const auto hi    = std::max(lo, std::min(cols, static_cast<std::size_t>(static_cast<std::ptrdiff_t>(w + in.pad_x) - first)));
+                    auto add_row = [&](std::ptrdiff_t y, int delta) {
+                        const std::uint8_t* row = in.row(border_index(y, static_cast<std::ptrdiff_t>(h), border));
+                        auto add = [&](std::size_t j, const std::uint8_t* p) {
+                            for (std::size_t ch = 0; ch != c; ++ch) {
+                                const auto v = p[ch];
+                                coarse_of(j, ch)[v >> 4] += delta;
+                                fine_of(j, ch)[v]        += delta;
+                            }
+                        };
+                        for (std::size_t j = 0; j != lo; ++j) { add(j, row + border_index(first + static_cast<std::ptrdiff_t>(j), static_cast<std::ptrdiff_t>(w), border) * c); }
+                        for (std::size_t j = lo; j != hi; ++j) { add(j, row + (first + static_cast<std::ptrdiff_t>(j)) * static_cast<std::ptrdiff_t>(c)); }
+                        for (std::size_t j = hi; j != cols; ++j) { add(j, row + border_index(first + static_cast<std::ptrdiff_t>(j), static_cast<std::ptrdiff_t>(w), border) * c); }
+                    };
+                    for (std::ptrdiff_t y = -static_cast<std::ptrdiff_t>(r); y <= static_cast<std::ptrdiff_t>(r); ++y) { add_row(y, 1); }
+
+                    for (std::size_t y = 0; y != h; ++y) {
+                        if (y != 0) {
+                            add_row(static_cast<std::ptrdiff_t>(y - 1 - r), -1);
+                            add_row(static_cast<std::ptrdiff_t>(y + r), 1);
+                        }
+                        // Window of output column x0 + x covers padded columns [x, x + span).
+                        std::fill(ker_coarse.begin(), ker_coarse.end(), 0);
+                        std::fill(ker_last.begin(), ker_last.end(), std::ptrdiff_t(-1) - static_cast<std::ptrdiff_t>(span));
+                        for (std::size_t j = 0; j != span; ++j) {
+                            for (std::size_t ch = 0; ch != c; ++ch) {
+                                std::uint32_t*       k = ker_coarse.data() + ch * coarse;
+                                const std::uint16_t* a = coarse_of(j, ch);
+                                for (std::size_t b = 0; b != coarse; ++b) { k[b] += a[b]; }
+                            }
+                        }
+                        std::uint8_t* d = out.data() + y * stride + x0 * c;
+                        for (std::size_t x = 0; x != x1 - x0; ++x) {
+                            for (std::size_t ch = 0; ch != c; ++ch) {
+                                std::uint32_t* kc = ker_coarse.data() + ch * coarse;
+                                if (x != 0) {
+                                    const std::uint16_t* add = coarse_of(x + span - 1, ch);
+                                    const std::uint16_t* sub = coarse_of(x - 1, ch);
+                                    for (std::size_t b = 0; b != coarse; ++b) { kc[b] += add[b] - sub[b]; }
+                                }
+                                std::uint32_t seen = 0;
+                                std::size_t   b    = 0;
+                                while (seen + kc[b] <= rank) { seen += kc[b++]; }
+                                // Bring fine segment b up to column x, from scratch when it is too far behind.
+                                std::uint32_t*  kf   = ker_fine.data() + ch * fine + b * coarse;
+                                std::ptrdiff_t& last = ker_last[ch * coarse + b];
+                                const auto      xi   = static_cast<std::ptrdiff_t>(x);
+                                if (xi - last >= static_cast<std::ptrdiff_t>(span)) {
+                                    std::fill_n(kf, coarse, 0);
+                                    for (std::size_t j = x; j != x + span; ++j) {
+                                        const std::uint16_t* a = fine_of(j, ch) + b * coarse;
+                                        for (std::size_t i = 0; i != coarse; ++i) { kf[i] += a[i]; }
+                                    }
+                                }
+                                else {
+                                    for (auto j = last + 1; j <= xi; ++j) {
+                                        const std::uint16_t* add = fine_of(static_cast<std::size_t>(j) + span - 1, ch) + b * coarse;
+                                        const std::uint16_t* sub = fine_of(static_cast<std::size_t>(j) - 1, ch) + b * coarse;
+                                        for (std::size_t i = 0; i != coarse; ++i) { kf[i] += add[i] - sub[i]; }
+                                    }
+                                }
+                                last = xi;
+                                std::size_t i = 0;
+                                while (seen + kf[i] <= rank) { seen += kf[i++]; }
+                                d[x * c + ch] = static_cast<std::uint8_t>(b * coarse + i);
+                            }
+                        }
+                    }
+                }
+            });
+        }
+    }
+
+    /// \brief  Median filter, every channel of every pixel becomes the median of that channel over the
+    ///         (2 * radius + 1) x (2 * radius + 1) square centred on it.
+    /// \example
+    /// median_filter_view(noisy, clean, 1);                             // 3x3, sorting network.
+    /// median_filter_view(scan, scan, 15, border_policy::mirror);       // 31x31, histograms, in place.
+    template <interleaved_pixel_concept SrcPix, interleaved_pixel_concept DstPix>
+        requires std::is_same_v<typename SrcPix::value_type, std::uint8_t> && std::is_same_v<typename DstPix::value_type, std::uint8_t>
+    void median_filter_view(const matrix_view<SrcPix> src, matrix_view<DstPix> dest, const std::size_t radius, const border_policy border = border_policy::clamp) {
+        static_assert(detail::pixel_channels_v<SrcPix> == detail::pixel_channels_v<DstPix>, "Channel count mismatch!");
+        if (src.width() != dest.width() || src.height() != dest.height()) {
+            throw std::runtime_error("Median source and destination size mismatch!");
+        }
+        if (2 * radius + 1 > std::numeric_limits<std::uint16_t>::max()) {
+            throw std::runtime_error("Median radius too large!");
+        }
+        if (src.width() == 0 || src.height() == 0) return;
+        // The networks read their whole window from the buffer. The histograms only need a row's worth of
+        // border on either side, anything further out is looked up, so the buffer stays within 3x the image.
+        const auto in = radius <= 2 ? detail::load_median_buffer(src, radius, radius, border)
+                                    : detail::load_median_buffer(src, std::min(radius, src.width()), 0, border);
+        std::vector<std::uint8_t> out(src.width() * src.height() * detail::pixel_channels_v<SrcPix>);
+        switch (radius) {
+        case 0:  for (std::size_t y = 0; y != src.height(); ++y) { std::copy_n(in.row(static_cast<std::ptrdiff_t>(y)), in.width * in.channels, out.data() + y * in.width * in.channels); } break;
+        case 1:  detail::median_by_network<1>(in, out);           break;
+        case 2:  detail::median_by_network<2>(in, out);           break;
+        default: detail::median_by_histogram(in, radius, border, out); break;
+        }
+        const auto stride = in.width * in.channels;
+        const auto bands  = force::detail::band_count(dest.height(), detail::median_min_elements / (stride + 1) + 1);
+        force::detail::for_each_band(dest.height(), bands, [&](std::size_t, std::size_t beg, std::size_t end) {
+            for (auto y = beg; y != end; ++y) { detail::write_channel_row(dest, static_cast<std::ptrdiff_t>(y), out.data() + y * stride, std::identity{}); }
+        });
+    }
+}
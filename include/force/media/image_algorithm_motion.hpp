@@ -0,0 +1,248 @@
+///
+/// \file      image_algorithm_motion.hpp
+/// \brief     Block-matching motion estimation between two grey frames.
+/// \details
+///
+/// The current frame is cut into 8x8 or 16x16 blocks. Every block gets the displacement into the
+/// previous frame with the smallest sum of absolute differences (SAD). Candidates must lie fully
+/// inside the previous frame and within the search range. Blocks that don't fit whole at the right
+/// and bottom edges are not estimated.
+///
+/// SAD rows are plain fixed-length loops over bytes, which the compiler turns into psadbw on x86
+/// (and its equivalents elsewhere). Search patterns:
+/// - full tests every displacement in the range.
+/// - diamond steps with the large diamond (8 points at distance 2) until the centre wins, then
+///   refines with the small one (4 points at distance 1).
+/// - hexagon steps with a 6 point hexagon, then refines with the 4 point cross.
+///
+/// With more than one level both frames are reduced into pyramids and blocks keep their size in
+/// pixels, so a coarse block sees the content of 4 finer ones. The coarsest level searches the
+/// reduced range. Every finer level starts from the doubled vectors of the covering coarse block and
+/// its neighbours, then refines by a step or two. So large motion is found without testing the full
+/// range at full size. Blocks of one level are independent and run in row bands on the shared
+/// thread pool, so the field doesn't depend on the thread count.
+///
+/// \author    HenryDu
+/// \date      18.10.2026
+/// \copyright © HenryDu 2026. All right reserved.
+///
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "force/execution.hpp"
+#include "force/media/image_algorithm_pyramid.hpp"
+#include "force/media/image_view.hpp"
+
+namespace force::media {
+    enum class motion_search {
+        full,     // Every displacement in the range.
+        diamond,  // Large then small diamond pattern.
+        hexagon   // Hexagon then cross pattern.
+    };
+
+    // Displacement of a block of the current frame into the previous one.
+    struct motion_vector {
+        std::int16_t  x   = 0, y = 0;
+        std::uint32_t sad = 0;
+    };
+
+    struct motion_options {
+        std::size_t    block  = 16;                     // 8 or 16.
+        std::ptrdiff_t range  = 16;                     // Largest displacement per axis, in pixels.
+        motion_search  search = motion_search::diamond;
+        std::size_t    levels = 1;                      // Pyramid levels, 1 searches the full size frames only.
+    };
+
+    namespace detail {
+        // Blocks per row below this amount are not worth a thread.
+        constexpr std::size_t motion_min_blocks = 64;
+
+        // Rows of 8bit values, either the view's own memory or a packed copy.
+        struct motion_plane {
+            const std::uint8_t*       data;
+            std::ptrdiff_t            stride, width, height;
+            std::vector<std::uint8_t> storage;
+
+            motion_plane(const matrix_view<grey_u8_pixel_t>& view) : stride(static_cast<std::ptrdiff_t>(view.width())),
+                                                                     width(static_cast<std::ptrdiff_t>(view.width())), height(static_cast<std::ptrdiff_t>(view.height())) {
+                if (is_flat_view(view)) {
+                    data   = flat_row_data(view, 0);
+                    stride = view.row_delta();
+                    return;
+                }
+                storage.resize(view.size());
+                for (std::ptrdiff_t y = 0; y != height; ++y) { read_channel_row(view, y, storage.data() + y * stride, std::identity{}); }
+                data = storage.data();
+            }
+            motion_plane(const motion_plane&) = delete;
+            const std::uint8_t* at(std::ptrdiff_t x, std::ptrdiff_t y) const { return data + y * stride + x; }
+        };
+
+        template <std::size_t N>
+        std::uint32_t block_sad(const std::uint8_t* a, const std::ptrdiff_t as, const std::uint8_t* b, const std::ptrdiff_t bs) {
+            std::uint32_t s = 0;
+            for (std::size_t r = 0; r != N; ++r, a += as, b += bs) {
+                for (std::size_t i = 0; i != N; ++i) { s += static_cast<std::uint32_t>(std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i]))); }
+            }
+            return s;
+        }
+        inline std::uint32_t block_sad(const std::uint8_t* a, const std::ptrdiff_t as, const std::uint8_t* b, const std::ptrdiff_t bs, const std::size_t n) {
+            return n == 16 ? block_sad<16>(a, as, b, bs) : block_sad<8>(a, as, b, bs);
+        }
+
+        // Search of one block of size n at (x, y), displacements are limited to limit per axis.
+        class motion_block_search {
+        public:
+            motion_block_search(const motion_plane& prev, const motion_plane& cur, std::ptrdiff_t x, std::ptrdiff_t y, std::size_t n, std::ptrdiff_t limit)
+                : mPrev(prev), mBlock(cur.at(x, y)), mCurStride(cur.stride), mX(x), mY(y), mN(n), mLimit(limit) {}
+
+            // Start from the best of the predictions, the zero vector is always tried as static background is the common case.
+            template <std::size_t K>
+            motion_vector run(const motion_search search, const std::array<motion_vector, K>& starts, const std::ptrdiff_t window) {
+                motion_vector best = probe(0, 0);
+                for (const auto& v : starts) { take(best, v.x, v.y); }
+                if (search == motion_search::full) {
+                    const motion_vector centre = best;
+                    for (auto dy = centre.y - window; dy <= centre.y + window; ++dy) {
+                        for (auto dx = centre.x - window; dx <= centre.x + window; ++dx) { take(best, dx, dy); }
+                    }
+                    return best;
+                }
+                static constexpr std::array<std::array<std::int8_t, 2>, 8> large_diamond{ { { 0, -2 }, { 1, -1 }, { 2, 0 }, { 1, 1 }, { 0, 2 }, { -1, 1 }, { -2, 0 }, { -1, -1 } } };
+                static constexpr std::array<std::array<std::int8_t, 2>, 6> hexagon{ { { -2, 0 }, { -1, -2 }, { 1, -2 }, { 2, 0 }, { 1, 2 }, { -1, 2 } } };
+                static constexpr std::array<std::array<std::int8_t, 2>, 4> cross{ { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } } };
+                if (search == motion_search::diamond) { descend(best, large_diamond); }
+                else                                  { descend(best, hexagon); }
+                const motion_vector centre = best;
+                for (const auto& o : cross) { take(best, centre.x + o[0], centre.y + o[1]); }
+                return best;
+            }
+        private:
+            // SAD of displacement (dx, dy), the largest value when it isn't allowed.
+            motion_vector probe(const std::ptrdiff_t dx, const std::ptrdiff_t dy) const {
+                const auto n = static_cast<std::ptrdiff_t>(mN);
+                const auto x = mX + dx, y = mY + dy;
+                const bool inside = std::abs(dx) <= mLimit && std::abs(dy) <= mLimit && x >= 0 && y >= 0 && x + n <= mPrev.width && y + n <= mPrev.height;
+                const auto sad = inside ? block_sad(mBlock, mCurStride, mPrev.at(x, y), mPrev.stride, mN) : std::numeric_limits<std::uint32_t>::max();
+                return { static_cast<std::int16_t>(dx), static_cast<std::int16_t>(dy), sad };
+            }
+            void take(motion_vector& best, const std::ptrdiff_t dx, const std::ptrdiff_t dy) const {
+                const auto c = probe(dx, dy);
+                if (c.sad < best.sad) best = c;
+            }
+            // Move the pattern's centre to its best point until the centre itself is best.
+            template <std::size_t K>
+            void descend(motion_vector& best, const std::array<std::array<std::int8_t, 2>, K>& pattern) const {
+                for (std::ptrdiff_t step = 0; step != 2 * mLimit + 2; ++step) {
+                    const motion_vector centre = best;
+                    for (const auto& o : pattern) { take(best, centre.x + o[0], centre.y + o[1]); }
+                    if (best.x == centre.x && best.y == centre.y) return;
+                }
+            }
+
+            const motion_plane& mPrev;
+            const std::uint8_t* mBlock;
+            std::ptrdiff_t      mCurStride, mX, mY;
+            std::size_t         mN;
+            std::ptrdiff_t      mLimit;
+        };
+
+        // Vectors of one pyramid level, blocks keep their size in pixels on every level.
+        struct motion_field {
+            std::vector<motion_vector> vectors;
+            std::size_t                width = 0, height = 0;
+
+            const motion_vector& at(std::ptrdiff_t x, std::ptrdiff_t y) const {
+                x = std::clamp<std::ptrdiff_t>(x, 0, static_cast<std::ptrdiff_t>(width) - 1);
+                y = std::clamp<std::ptrdiff_t>(y, 0, static_cast<std::ptrdiff_t>(height) - 1);
+                return vectors[static_cast<std::size_t>(y) * width + static_cast<std::size_t>(x)];
+            }
+        };
+
+        // One level of the search. Blocks of a finer level start from the doubled vectors of the block
+        // that covers them one level up and of its 4 neighbours, so a wrong coarse vector can be
+        // replaced by the motion around it.
+        inline void motion_level(const motion_plane& prev, const motion_plane& cur, motion_field& field, const motion_field* coarse, const std::size_t n,
+                                 const std::ptrdiff_t limit, const motion_search search, const std::ptrdiff_t window) {
+            const auto bands = force::detail::band_count(field.height, motion_min_blocks / (field.width + 1) + 1);
+            force::detail::for_each_band(field.height, bands, [&](std::size_t, std::size_t beg, std::size_t end) {
+                for (auto by = beg; by != end; ++by) {
+                    for (std::size_t bx = 0; bx != field.width; ++bx) {
+                        std::array<motion_vector, 5> starts{};
+                        if (coarse != nullptr) {
+                            const auto px = static_cast<std::ptrdiff_t>(bx / 2), py = static_cast<std::ptrdiff_t>(by / 2);
+                            const std::array<std::array<std::ptrdiff_t, 2>, 5> parents{ { { px, py }, { px - 1, py }, { px + 1, py }, { px, py - 1 }, { px, py + 1 } } };
+                            for (std::size_t i = 0; i != parents.size(); ++i) {
+                                const auto& v = coarse->at(parents[i][0], parents[i][1]);
+                                starts[i] = { static_cast<std::int16_t>(v.x * 2), static_cast<std::int16_t>(v.y * 2), 0 };
+                            }
+                        }
+                        motion_block_search s(prev, cur, static_cast<std::ptrdiff_t>(bx * n), static_cast<std::ptrdiff_t>(by * n), n, limit);
+                        field.vectors[by * field.width + bx] = s.run(search, starts, window);
+                    }
+                }
+            });
+        }
+    }
+
+    /// \brief  Field size in blocks for w x h frames.
+    constexpr std::size_t motion_field_width(const std::size_t w, const motion_options& options)  { return w / options.block; }
+    constexpr std::size_t motion_field_height(const std::size_t h, const motion_options& options) { return h / options.block; }
+
+    /// \brief  Block motion from prev to cur into field, which is motion_field_width x motion_field_height blocks.
+    /// \note   Coarse levels whose frames are smaller than a block are dropped.
+    /// \example
+    /// motion_options opt{ .block = 16, .range = 32, .search = motion_search::hexagon, .levels = 3 };
+    /// std::vector<motion_vector> mv(motion_field_width(w, opt) * motion_field_height(h, opt));
+    /// estimate_motion_view(prev, cur, matrix_view<motion_vector>(mv.data(), 0, 0, w / 16, h / 16, w / 16), opt);
+    inline void estimate_motion_view(const matrix_view<grey_u8_pixel_t> prev, const matrix_view<grey_u8_pixel_t> cur, matrix_view<motion_vector> field,
+                                     const motion_options& options = {}) {
+        if (options.block != 8 && options.block != 16) throw std::runtime_error("Motion blocks are 8x8 or 16x16!");
+        if (prev.width() != cur.width() || prev.height() != cur.height()) throw std::runtime_error("Frame size mismatch!");
+        if (field.width() != motion_field_width(cur.width(), options) || field.height() != motion_field_height(cur.height(), options)) {
+            throw std::runtime_error("Motion field size mismatch!");
+        }
+        if (options.range < 0 || options.range > std::numeric_limits<std::int16_t>::max() / 2) throw std::runtime_error("Motion range out of bounds!");
+        if (field.size() == 0) return;
+        auto levels = std::max<std::size_t>(options.levels, 1);
+        while (levels > 1 && ((cur.width() >> (levels - 1)) < options.block || (cur.height() >> (levels - 1)) < options.block)) --levels;
+
+        auto solve = [&](const detail::motion_plane& p, const detail::motion_plane& c, detail::motion_field& out, const detail::motion_field* coarse, const std::size_t l) {
+            out.width  = static_cast<std::size_t>(c.width) / options.block;
+            out.height = static_cast<std::size_t>(c.height) / options.block;
+            out.vectors.assign(out.width * out.height, {});
+            // Coarse levels search at least a pixel, the finest one exactly options.range (0 means no motion).
+            const auto limit = l == 0 ? options.range : std::max<std::ptrdiff_t>(1, options.range >> l);
+            // Finer levels only correct the doubled vectors of the level above by a pixel or two.
+            detail::motion_level(p, c, out, coarse, options.block, limit, options.search, coarse == nullptr ? limit : 2);
+        };
+        detail::motion_field result;
+        if (levels == 1) {
+            const detail::motion_plane p(prev), c(cur);
+            solve(p, c, result, nullptr, 0);
+        }
+        else {
+            const auto prev_levels = build_pyramid(prev, pyramid_filter::box, levels);
+            const auto cur_levels  = build_pyramid(cur, pyramid_filter::box, levels);
+            detail::motion_field coarse;
+            for (auto l = levels; l-- != 0;) {
+                const detail::motion_plane p(prev_levels.level(l)), c(cur_levels.level(l));
+                solve(p, c, result, l + 1 == levels ? nullptr : &coarse, l);
+                std::swap(result, coarse);
+            }
+            std::swap(result, coarse);
+        }
+        for (std::size_t y = 0; y != field.height(); ++y) {
+            for (std::size_t x = 0; x != field.width(); ++x) {
+                field[force::vector<std::ptrdiff_t, 2>(static_cast<std::ptrdiff_t>(x), static_cast<std::ptrdiff_t>(y))] = result.vectors[y * result.width + x];
+            }
+        }
+    }
+}
@@ -0,0 +1,285 @@
+///
+/// \file      image_algorithm_pyramid.hpp
+/// \brief     Image pyramids (mip chains) built in one streaming pass.
+/// \details
+///
+/// Level 0 is a copy of the source and every next level has half the size, rounded down and never
+/// below 1, until the last level is 1x1 (or the requested level count is reached). All levels live in
+/// one contiguous arena, and level(i) is a matrix_view into it.
+///
+/// A pixel averages exactly the area of the previous level it covers. With an odd size that area is
+/// two and a half pixels, so it takes three taps, e.g. 5 -> 2 weighs (2, 2, 1) / 5 and (1, 2, 2) / 5,
+/// instead of dropping the last row or column. pyramid_filter::gaussian5 first smooths with the
+/// binomial [1 4 6 4 1] / 16, and both steps are folded into one set of taps per axis.
+///
+/// The source is read once, top to bottom. Every finished row of a level is reduced horizontally
+/// into a small ring, and as soon as the ring holds all the rows the next row of the level below
+/// needs, that row is produced too. So every level is produced while its input is still in
+/// cache. The cascade works on float rows, so with srgb = true all levels are averaged in
+/// linear light and only rounded back to sRGB when stored.
+///
+/// \author    HenryDu
+/// \date      18.10.2026
+/// \copyright © HenryDu 2026. All right reserved.
+///
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include "force/media/image_algorithm_gamma.hpp"
+
+namespace force::media {
+    enum class pyramid_filter {
+        box,        // Area average.
+        gaussian5   // Binomial [1 4 6 4 1] smoothing, then area average.
+    };
+
+    /// \class   image_pyramid
+    /// \brief   Every level of a pyramid in one arena, level 0 is full size.
+    template <interleaved_pixel_concept Pix>
+    class image_pyramid {
+    public:
+        image_pyramid() = default;
+        /// \brief  Layout for a w x h level 0 and at most max_levels levels (0 means down to 1x1).
+        image_pyramid(std::size_t w, std::size_t h, std::size_t max_levels = 0) {
+            std::size_t offset = 0;
+            while (w != 0 && h != 0) {
+                mLevels.push_back({ offset, w, h });
+                offset += w * h;
+                if ((w == 1 && h == 1) || mLevels.size() == max_levels) break;
+                w = std::max<std::size_t>(1, w / 2);
+                h = std::max<std::size_t>(1, h / 2);
+            }
+            mArena.resize(offset);
+        }
+
+        std::size_t      levels()                 const { return mLevels.size(); }
+        std::size_t      width(std::size_t i)     const { return mLevels[i].width; }
+        std::size_t      height(std::size_t i)    const { return mLevels[i].height; }
+        matrix_view<Pix> level(std::size_t i)     const {
+            const auto& l = mLevels[i];
+            return matrix_view<Pix>(mArena.data() + l.offset, 0, 0, l.width, l.height, static_cast<std::ptrdiff_t>(l.width));
+        }
+        matrix_view<Pix> operator[](std::size_t i) const { return level(i); }
+
+        // The whole arena, level after level, every level has packed rows.
+        const Pix*       data()                   const { return mArena.data(); }
+        Pix*             data()                         { return mArena.data(); }
+        std::size_t      size()                   const { return mArena.size(); }
+
+        ~image_pyramid() = default;
+    private:
+        struct level_info {
+            std::size_t offset, width, height;
+        };
+        std::vector<Pix>        mArena;
+        std::vector<level_info> mLevels;
+    };
+
+    namespace detail {
+        // Ring rows kept per level, more than the widest vertical footprint (7 rows).
+        constexpr std::size_t pyramid_ring = 8;
+
+        // 1D reduction from n to m samples, output i is sum of weight[i * taps + t] * input[index[i * taps + t]].
+        struct pyramid_taps {
+            std::vector<std::size_t> index;
+            std::vector<float32_t>   weight;
+            std::size_t              taps  = 0;
+            bool                     pairs = false;  // Exactly (2i, 2i + 1) with 1/2 each.
+        };
+        inline pyramid_taps make_pyramid_taps(const std::size_t n, const std::size_t m, const pyramid_filter filter) {
+            // Area taps: output i covers [i * n / m, (i + 1) * n / m) of the input.
+            std::vector<std::vector<std::pair<std::ptrdiff_t, float64_t>>> area(m);
+            const auto scale = static_cast<float64_t>(n) / static_cast<float64_t>(m);
+            for (std::size_t i = 0; i != m; ++i) {
+                const auto beg = static_cast<float64_t>(i) * scale, end = static_cast<float64_t>(i + 1) * scale;
+                for (auto s = static_cast<std::ptrdiff_t>(std::floor(beg)); static_cast<float64_t>(s) < end; ++s) {
+                    const auto cover = std::min(end, static_cast<float64_t>(s + 1)) - std::max(beg, static_cast<float64_t>(s));
+                    if (cover > 1e-12) { area[i].emplace_back(s, cover / scale); }
+                }
+            }
+            if (filter == pyramid_filter::gaussian5) {
+                constexpr float64_t binomial[5] = { 1.0 / 16, 4.0 / 16, 6.0 / 16, 4.0 / 16, 1.0 / 16 };
+                for (auto& a : area) {
+                    std::vector<std::pair<std::ptrdiff_t, float64_t>> wide;
+                    for (const auto& [s, w] : a) {
+                        for (std::ptrdiff_t k = -2; k <= 2; ++k) { wide.emplace_back(s + k, w * binomial[k + 2]); }
+                    }
+                    a = std::move(wide);
+                }
+            }
+            pyramid_taps t;
+            for (const auto& a : area) { t.taps = std::max(t.taps, a.size()); }
+            t.index.assign(m * t.taps, 0);
+            t.weight.assign(m * t.taps, 0.F);
+            const auto last = static_cast<std::ptrdiff_t>(n) - 1;
+            for (std::size_t i = 0; i != m; ++i) {
+                for (std::size_t k = 0; k != area[i].size(); ++k) {
+                    // Past the edges repeat the edge sample.
+                    t.index [i * t.taps + k] = static_cast<std::size_t>(std::clamp<std::ptrdiff_t>(area[i][k].first, 0, last));
+                    t.weight[i * t.taps + k] = static_cast<float32_t>(area[i][k].second);
+                }
+                for (std::size_t k = area[i].size(); k != t.taps; ++k) { t.index[i * t.taps + k] = t.index[i * t.taps]; }
+            }
+            t.pairs = filter == pyramid_filter::box && n == 2 * m;
+            return t;
+        }
+
+        // Horizontal reduction of one row of width * channels floats.
+        template <std::size_t Channels>
+        void pyramid_reduce_row(const float32_t* in, float32_t* out, const pyramid_taps& t, const std::size_t m) {
+            constexpr auto channels = Channels;
+            if (t.pairs) {
+                // 2x1 box, the common case: channels of two neighbours averaged, vectorizes across the row.
+                for (std::size_t x = 0; x != m; ++x) {
+                    for (std::size_t c = 0; c != channels; ++c) { out[x * channels + c] = (in[2 * x * channels + c] + in[(2 * x + 1) * channels + c]) * 0.5F; }
+                }
+                return;
+            }
+            std::fill_n(out, m * channels, 0.F);
+            for (std::size_t x = 0; x != m; ++x) {
+                for (std::size_t k = 0; k != t.taps; ++k) {
+                    const float32_t  w = t.weight[x * t.taps + k];
+                    const float32_t* s = in + t.index[x * t.taps + k] * channels;
+                    for (std::size_t c = 0; c != channels; ++c) { out[x * channels + c] += w * s[c]; }
+                }
+            }
+        }
+
+        template <typename Pix>
+        struct pyramid_builder {
+            using value_t = typename Pix::value_type;
+            static constexpr std::size_t channels = pixel_channels_v<Pix>;
+
+            // One level that still has rows to produce.
+            struct stage {
+                pyramid_taps           h, v;
+                std::vector<float32_t> ring;      // Horizontally reduced rows of the level above, pyramid_ring of them.
+                std::vector<float32_t> out;       // Row being produced.
+                std::size_t            next = 0;  // Next row of this level to produce.
+            };
+
+            image_pyramid<Pix>&    pyramid;
+            bool                   srgb;
+            std::ptrdiff_t         alpha_channel;
+            std::vector<stage>     stages;       // stages[l] produces level l + 1.
+            std::vector<float32_t> row;
+            std::vector<value_t>   stored;
+
+            pyramid_builder(image_pyramid<Pix>& p, const pyramid_filter filter, const bool s, const std::ptrdiff_t alpha)
+                : pyramid(p), srgb(s), alpha_channel(alpha), stages(p.levels() == 0 ? 0 : p.levels() - 1),
+                  row(p.levels() == 0 ? 0 : p.width(0) * channels), stored(row.size()) {
+                for (std::size_t l = 0; l != stages.size(); ++l) {
+                    stages[l].h = make_pyramid_taps(p.width(l),  p.width(l + 1),  filter);
+                    stages[l].v = make_pyramid_taps(p.height(l), p.height(l + 1), filter);
+                    stages[l].ring.resize(pyramid_ring * p.width(l + 1) * channels);
+                    stages[l].out.resize(p.width(l + 1) * channels);
+                }
+            }
+
+            // Channel c is stored sRGB encoded.
+            bool gamma(const std::size_t c) const { return srgb && static_cast<std::ptrdiff_t>(c) != alpha_channel; }
+
+            void decode_row(const value_t* in, float32_t* out, const std::size_t w) const {
+                if constexpr (std::is_same_v<value_t, std::uint8_t>) {
+                    // 8bit channels decode through a table each: sRGB, alpha (to [0, 1]) or plain.
+                    static const auto plain = [] { std::array<float32_t, 256> t{}; for (std::size_t i = 0; i != 256; ++i) { t[i] = static_cast<float32_t>(i); } return t; }();
+                    static const auto unit  = [] { std::array<float32_t, 256> t{}; for (std::size_t i = 0; i != 256; ++i) { t[i] = static_cast<float32_t>(i) / 255.F; } return t; }();
+                    std::array<const float32_t*, channels> table;
+                    for (std::size_t c = 0; c != channels; ++c) {
+                        table[c] = !srgb ? plain.data() : gamma(c) ? detail::get_srgb_tables().decode_f32.data() : unit.data();
+                    }
+                    for (std::size_t x = 0; x != w; ++x) {
+                        for (std::size_t c = 0; c != channels; ++c) { out[x * channels + c] = table[c][in[x * channels + c]]; }
+                    }
+                }
+                else {
+                    for (std::size_t i = 0; i != w * channels; ++i) { out[i] = static_cast<float32_t>(in[i]); }
+                }
+            }
+            void encode_row(const float32_t* in, value_t* out, const std::size_t w) const {
+                if constexpr (std::is_same_v<value_t, std::uint8_t>) {
+                    if (srgb) {
+                        for (std::size_t x = 0; x != w; ++x) {
+                            for (std::size_t c = 0; c != channels; ++c) {
+                                const auto v = in[x * channels + c];
+                                out[x * channels + c] = gamma(c) ? linear_to_srgb(v) : static_cast<value_t>(clamp(v, 0.F, 1.F) * 255.F + 0.5F);
+                            }
+                        }
+                        return;
+                    }
+                }
+                // Weights are positive and sum to one, so results stay in range and only need rounding.
+                for (std::size_t i = 0; i != w * channels; ++i) {
+                    if constexpr (std::is_floating_point_v<value_t>) { out[i] = static_cast<value_t>(in[i]); }
+                    else if constexpr (std::is_unsigned_v<value_t>)  { out[i] = static_cast<value_t>(in[i] + 0.5F); }
+                    else                                             { out[i] = static_cast<value_t>(std::lround(in[i])); }
+                }
+            }
+
+            // Row y of level l is done (in linear floats): reduce it into the ring of stage l and produce whatever it unblocks.
+            void push(const std::size_t l, const std::size_t y, const float32_t* data) {
+                if (l == stages.size()) return;
+                auto&      s = stages[l];
+                const auto m = pyramid.width(l + 1) * channels;
+                pyramid_reduce_row<channels>(data, s.ring.data() + (y % pyramid_ring) * m, s.h, pyramid.width(l + 1));
+                const auto last = pyramid.height(l) - 1;
+                auto&      out  = s.out;
+                while (s.next != pyramid.height(l + 1)) {
+                    // The bottom tap of a row is its largest one.
+                    const auto j = s.next;
+                    std::size_t need = 0;
+                    for (std::size_t k = 0; k != s.v.taps; ++k) { need = std::max(need, s.v.index[j * s.v.taps + k]); }
+                    if (need > y && y != last) break;
+                    std::fill(out.begin(), out.end(), 0.F);
+                    for (std::size_t k = 0; k != s.v.taps; ++k) {
+                        const float32_t  w = s.v.weight[j * s.v.taps + k];
+                        const float32_t* r = s.ring.data() + (s.v.index[j * s.v.taps + k] % pyramid_ring) * m;
+                        if (w == 0.F) continue;
+                        for (std::size_t i = 0; i != m; ++i) { out[i] += w * r[i]; }
+                    }
+                    store(l + 1, j, out.data());
+                    ++s.next;
+                    push(l + 1, j, out.data());
+                }
+            }
+            void store(const std::size_t l, const std::size_t y, const float32_t* data) {
+                encode_row(data, stored.data(), pyramid.width(l));
+                write_channel_row(pyramid.level(l), static_cast<std::ptrdiff_t>(y), stored.data(), std::identity{});
+            }
+            template <typename SrcPix>
+            void run(const matrix_view<SrcPix>& src) {
+                if (pyramid.levels() == 0) return;
+                for (std::size_t y = 0; y != pyramid.height(0); ++y) {
+                    read_channel_row(src, static_cast<std::ptrdiff_t>(y), stored.data(), std::identity{});
+                    write_channel_row(pyramid.level(0), static_cast<std::ptrdiff_t>(y), stored.data(), std::identity{});
+                    decode_row(stored.data(), row.data(), pyramid.width(0));
+                    push(0, y, row.data());
+                }
+            }
+        };
+    }
+
+    /// \brief  Build every level of a pyramid of src.
+    /// \param  levels        - Level count, level 0 included, 0 goes down to 1x1.
+    /// \param  srgb          - 8bit pixels only: average in linear light instead of on the stored sRGB values.
+    /// \param  alpha_channel - With srgb, the channel that is linear already (-1 for none).
+    /// \example
+    /// auto mips = build_pyramid(texture, pyramid_filter::box, 0, true, 3);
+    /// for (std::size_t i = 0; i != mips.levels(); ++i) { upload(i, mips.level(i)); }
+    template <interleaved_pixel_concept Pix>
+    image_pyramid<Pix> build_pyramid(const matrix_view<Pix> src, const pyramid_filter filter = pyramid_filter::box, const std::size_t levels = 0,
+                                     const bool srgb = false, const std::ptrdiff_t alpha_channel = -1) {
+        if (srgb && !std::is_same_v<typename Pix::value_type, std::uint8_t>) {
+            throw std::runtime_error("sRGB pyramid needs 8bit channels!");
+        }
+        image_pyramid<Pix> pyramid(src.width(), src.height(), levels);
+        detail::pyramid_builder<Pix> builder(pyramid, filter, srgb, alpha_channel);
+        builder.run(src);
+        return pyramid;
+    }
+}
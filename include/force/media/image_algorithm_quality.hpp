@@ -0,0 +1,345 @@
+///
+/// \file      image_algorithm_quality.hpp
+/// \brief     Full reference image quality metrics: MSE, PSNR, SSIM and MS-SSIM, per channel.
+/// \details
+///
+/// Every metric compares two views of the same pixel type and size and returns one score per channel
+/// in p[c] order. Row bands run on the shared thread pool, partial sums are combined in band order so
+/// results don't depend on the thread count.
+///
+/// MSE accumulates squared differences in 32bit integers for 8bit channels (flushed before they can
+/// overflow) and in double otherwise. PSNR uses the channel's maximum value as peak, 1 for floating
+/// point channels.
+///
+/// SSIM follows Wang et al.: 11x11 Gaussian window with sigma 1.5 (or an 8x8 box), K1 = 0.01,
+/// K2 = 0.03, only windows that lie fully inside the image are scored. Each band streams its rows
+/// once: a row is converted to float, filtered horizontally producing all five window moments (means,
+/// second moments and the cross term) in one fused loop, and kept in a ring of window height rows
+/// from which the vertical pass evaluates the SSIM map and sums it on the fly. The map is never stored.
+///
+/// MS-SSIM uses five scales with the weights of the original paper, halving with a 2x2 mean in between,
+/// and needs both sides to be at least 16 windows large.
+///
+/// \author    HenryDu
+/// \date      18.10.2026
+/// \copyright © HenryDu 2026. All right reserved.
+///
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "force/execution.hpp"
+#include "force/media/image_view.hpp"
+
+namespace force::media {
+    enum class ssim_window {
+        gaussian, // 11x11, sigma 1.5, the reference window.
+        box       // 8x8 uniform, cheaper and without the Gaussian's smooth fall off.
+    };
+
+    // One score per channel.
+    template <interleaved_pixel_concept Pix>
+    using channel_scores_t = std::array<float64_t, detail::pixel_channels_v<Pix>>;
+
+    namespace detail {
+        constexpr std::size_t quality_min_elements = 1 << 16;
+        // Elements per chunk of the fused window loops, small enough that all accumulators stay in registers or L1.
+        constexpr std::size_t quality_chunk        = 64;
+
+        template <typename Ty>
+        constexpr float64_t quality_peak() {
+            if constexpr (std::is_floating_point_v<Ty>) { return 1.0; }
+            else                                        { return static_cast<float64_t>(std::numeric_limits<Ty>::max()); }
+        }
+
+        template <typename PixA, typename PixB>
+        void check_quality_views(const matrix_view<PixA>& a, const matrix_view<PixB>& b) {
+            if (a.width() != b.width() || a.height() != b.height()) throw std::runtime_error("Compared views have different sizes!");
+            if (a.width() == 0 || a.height() == 0) throw std::runtime_error("Compared views are empty!");
+        }
+
+        template <typename Pix>
+        channel_scores_t<Pix> mean_squared_error(const matrix_view<Pix> a, const matrix_view<Pix> b) {
+            using value_t = typename Pix::value_type;
+            constexpr auto channels = pixel_channels_v<Pix>;
+            // 8bit differences squared are below 2^16, so 2^16 rows of them fit in 32 bits.
+            constexpr bool small  = std::is_integral_v<value_t> && sizeof(value_t) == 1;
+            using work_t          = std::conditional_t<small, std::int32_t, float64_t>;
+            using acc_t           = std::conditional_t<small, std::uint32_t, float64_t>;
+            constexpr std::size_t flush_rows = small ? (std::size_t(1) << 16) : std::numeric_limits<std::size_t>::max();
+
+            const auto w = a.width(), h = a.height(), n = w * channels;
+            const auto bands = force::detail::band_count(h, quality_min_elements / n + 1);
+            std::vector<std::array<float64_t, channels>> partial(bands);
+            force::detail::for_each_band(h, bands, [&](std::size_t band, std::size_t beg, std::size_t end) {
+                std::vector<work_t> ra(n), rb(n);
+                std::vector<acc_t>  col(n, acc_t(0));
+                auto& sum = partial[band];
+                sum.fill(0.0);
+                auto flush = [&] {
+                    for (std::size_t x = 0; x != w; ++x) {
+                        for (std::size_t c = 0; c != channels; ++c) { sum[c] += static_cast<float64_t>(col[x * channels + c]); }
+                    }
+                    std::fill(col.begin(), col.end(), acc_t(0));
+                };
+                for (auto y = beg; y != end; ++y) {
+                    read_channel_row(a, static_cast<std::ptrdiff_t>(y), ra.data(), [](const auto v) { return static_cast<work_t>(v); });
+                    read_channel_row(b, static_cast<std::ptrdiff_t>(y), rb.data(), [](const auto v) { return static_cast<work_t>(v); });
+                    const work_t* pa = ra.data();
+                    const work_t* pb = rb.data();
+                    acc_t*        pc = col.data();
+                    for (std::size_t i = 0; i != n; ++i) {
+                        const auto d = pa[i] - pb[i];
+                        pc[i] += static_cast<acc_t>(d * d);
+                    }
+                    if ((y - beg + 1) % flush_rows == 0) flush();
+                }
+                flush();
+            });
+            channel_scores_t<Pix> mse{};
+            for (const auto& s : partial) {
+                for (std::size_t c = 0; c != channels; ++c) { mse[c] += s[c]; }
+            }
+            for (auto& v : mse) { v /= static_cast<float64_t>(w * h); }
+            return mse;
+        }
+
+        inline std::vector<float32_t> ssim_taps(const ssim_window window) {
+            if (window == ssim_window::box) { return std::vector<float32_t>(8, 1.0f / 8.0f); }
+            std::vector<float32_t> taps(11);
+            float64_t sum = 0.0;
+            for (std::size_t i = 0; i != taps.size(); ++i) {
+                const auto d = static_cast<float64_t>(i) - 5.0;
+                sum += taps[i] = static_cast<float32_t>(std::exp(-d * d / (2.0 * 1.5 * 1.5)));
+            }
+            for (auto& t : taps) { t = static_cast<float32_t>(t / sum); }
+            return taps;
+        }
+
+        // Per channel sums of the SSIM map and of its contrast-structure term over all scored windows.
+        template <std::size_t Channels>
+        struct ssim_sums {
+            std::array<float64_t, Channels> ssim{}, cs{};
+            std::size_t                     count = 0;
+        };
+
+        // The five window moments of one filtered row, each ow * channels floats.
+        struct ssim_moments {
+            std::vector<float32_t> a, b, aa, bb, ab;
+            explicit ssim_moments(std::size_t n) : a(n), b(n), aa(n), bb(n), ab(n) {}
+        };
+
+        // Horizontal pass: all five moments of row pair (ra, rb) in one sweep, n outputs spaced stride apart per tap.
+        // n is a multiple of quality_chunk and the rows are padded far enough for that.
+        inline void ssim_filter_row(const float32_t* ra, const float32_t* rb, const std::vector<float32_t>& taps,
+                                    const std::size_t stride, const std::size_t n, ssim_moments& out) {
+            for (std::size_t i0 = 0; i0 != n; i0 += quality_chunk) {
+                // Local accumulators can't alias the inputs, which is what lets this vectorize.
+                std::array<float32_t, quality_chunk> sa{}, sb{}, saa{}, sbb{}, sab{};
+                // Windows are symmetric, so taps k and size - 1 - k share one multiply.
+                const auto size = taps.size();
+                for (std::size_t k = 0; k != size / 2; ++k) {
+                    const float32_t  t   = taps[k];
+                    const float32_t* pa0 = ra + i0 + k * stride;
+                    const float32_t* pb0 = rb + i0 + k * stride;
+                    const float32_t* pa1 = ra + i0 + (size - 1 - k) * stride;
+                    const float32_t* pb1 = rb + i0 + (size - 1 - k) * stride;
+                    for (std::size_t j = 0; j != quality_chunk; ++j) {
+                        const auto u0 = pa0[j], v0 = pb0[j], u1 = pa1[j], v1 = pb1[j];
+                        sa[j]  += t * (u0 + u1);           sb[j]  += t * (v0 + v1);
+                        saa[j] += t * (u0 * u0 + u1 * u1); sbb[j] += t * (v0 * v0 + v1 * v1); sab[j] += t * (u0 * v0 + u1 * v1);
+                    }
+                }
+                if (size % 2 != 0) {
+                    const float32_t  t  = taps[size / 2];
+                    const float32_t* pa = ra + i0 + size / 2 * stride;
+                    const float32_t* pb = rb + i0 + size / 2 * stride;
+                    for (std::size_t j = 0; j != quality_chunk; ++j) {
+                        const auto u = pa[j], v = pb[j];
+                        sa[j] += t * u; sb[j] += t * v; saa[j] += t * u * u; sbb[j] += t * v * v; sab[j] += t * u * v;
+                    }
+                }
+                std::ranges::copy(sa, out.a.data() + i0);
+                std::ranges::copy(sb, out.b.data() + i0);
+                std::ranges::copy(saa, out.aa.data() + i0);
+                std::ranges::copy(sbb, out.bb.data() + i0);
+                std::ranges::copy(sab, out.ab.data() + i0);
+            }
+        }
+        // Vertical pass over the ring rows starting at top, adds the SSIM and contrast-structure maps of one output row to sums.
+        inline void ssim_accumulate_row(const std::vector<ssim_moments>& ring, const std::size_t top, const std::vector<float32_t>& taps,
+                                        const float32_t c1, const float32_t c2, const std::size_t n, float64_t* sum_ssim, float64_t* sum_cs) {
+            const auto size = taps.size();
+            for (std::size_t i0 = 0; i0 != n; i0 += quality_chunk) {
+                std::array<float32_t, quality_chunk> ma{}, mb{}, maa{}, mbb{}, mab{};
+                for (std::size_t k = 0; k != size / 2; ++k) {
+                    const float32_t     t  = taps[k];
+                    const ssim_moments& r0 = ring[(top + k) % size];
+                    const ssim_moments& r1 = ring[(top + size - 1 - k) % size];
+                    for (std::size_t j = 0; j != quality_chunk; ++j) {
+                        ma[j]  += t * (r0.a[i0 + j] + r1.a[i0 + j]);   mb[j]  += t * (r0.b[i0 + j] + r1.b[i0 + j]);
+                        maa[j] += t * (r0.aa[i0 + j] + r1.aa[i0 + j]); mbb[j] += t * (r0.bb[i0 + j] + r1.bb[i0 + j]);
+                        mab[j] += t * (r0.ab[i0 + j] + r1.ab[i0 + j]);
+                    }
+                }
+                if (size % 2 != 0) {
+                    const float32_t     t = taps[size / 2];
+                    const ssim_moments& r = ring[(top + size / 2) % size];
+                    for (std::size_t j = 0; j != quality_chunk; ++j) {
+                        ma[j] += t * r.a[i0 + j]; mb[j] += t * r.b[i0 + j]; maa[j] += t * r.aa[i0 + j]; mbb[j] += t * r.bb[i0 + j]; mab[j] += t * r.ab[i0 + j];
+                    }
+                }
+                std::array<float32_t, quality_chunk> ssim, cs;
+                for (std::size_t j = 0; j != quality_chunk; ++j) {
+                    const auto a2 = ma[j] * ma[j], b2 = mb[j] * mb[j], ab = ma[j] * mb[j];
+                    cs[j]   = (2.0f * (mab[j] - ab) + c2) / ((maa[j] - a2) + (mbb[j] - b2) + c2);
+                    ssim[j] = cs[j] * (2.0f * ab + c1) / (a2 + b2 + c1);
+                }
+                for (std::size_t j = 0; j != quality_chunk; ++j) { sum_ssim[i0 + j] += static_cast<float64_t>(ssim[j]); }
+                for (std::size_t j = 0; j != quality_chunk; ++j) { sum_cs[i0 + j]   += static_cast<float64_t>(cs[j]); }
+            }
+        }
+
+        /// \brief  Sum SSIM over every window of a w x h image pair, load(y, a, b) writes row y of both
+        ///         images as w * Channels floats.
+        template <std::size_t Channels, typename Load>
+        ssim_sums<Channels> ssim_pass(const std::size_t w, const std::size_t h, const std::vector<float32_t>& taps, const float64_t peak, Load load) {
+            const auto size = taps.size();
+            const auto ow = w - size + 1, oh = h - size + 1, n = ow * Channels;
+            // Rows are processed in whole chunks, the tail past n is zero padding whose results are dropped.
+            const auto padded = (n + quality_chunk - 1) / quality_chunk * quality_chunk;
+            const auto c1 = static_cast<float32_t>((0.01 * peak) * (0.01 * peak));
+            const auto c2 = static_cast<float32_t>((0.03 * peak) * (0.03 * peak));
+
+            const auto bands = force::detail::band_count(oh, std::max(4 * size, quality_min_elements / n + 1));
+            std::vector<ssim_sums<Channels>> partial(bands);
+            force::detail::for_each_band(oh, bands, [&](std::size_t band, std::size_t beg, std::size_t end) {
+                std::vector<float32_t>    ra(padded + (size - 1) * Channels, 0.0f), rb(ra.size(), 0.0f);
+                std::vector<ssim_moments> ring(size, ssim_moments(padded));
+                std::vector<float64_t>    col_ssim(padded, 0.0), col_cs(padded, 0.0);
+                for (auto y = beg; y != end + size - 1; ++y) {
+                    load(y, ra.data(), rb.data());
+                    ssim_filter_row(ra.data(), rb.data(), taps, Channels, padded, ring[y % size]);
+                    if (y >= beg + size - 1) { ssim_accumulate_row(ring, y + 1 - size, taps, c1, c2, padded, col_ssim.data(), col_cs.data()); }
+                }
+                auto& s = partial[band];
+                for (std::size_t x = 0; x != ow; ++x) {
+                    for (std::size_t c = 0; c != Channels; ++c) {
+                        s.ssim[c] += col_ssim[x * Channels + c];
+                        s.cs[c]   += col_cs[x * Channels + c];
+                    }
+                }
+                s.count = ow * (end - beg);
+            });
+            ssim_sums<Channels> total;
+            for (const auto& s : partial) {
+                for (std::size_t c = 0; c != Channels; ++c) { total.ssim[c] += s.ssim[c]; total.cs[c] += s.cs[c]; }
+                total.count += s.count;
+            }
+            return total;
+        }
+
+        template <typename Pix>
+        auto ssim_view_loader(const matrix_view<Pix>& a, const matrix_view<Pix>& b) {
+            return [&a, &b](std::size_t y, float32_t* ra, float32_t* rb) {
+                read_channel_row(a, static_cast<std::ptrdiff_t>(y), ra, [](const auto v) { return static_cast<float32_t>(v); });
+                read_channel_row(b, static_cast<std::ptrdiff_t>(y), rb, [](const auto v) { return static_cast<float32_t>(v); });
+            };
+        }
+
+        // Halve a w x h image of interleaved float channels with a 2x2 mean (odd edges are dropped).
+        template <std::size_t Channels>
+        std::vector<float32_t> ssim_downsample(const std::vector<float32_t>& in, const std::size_t w, const std::size_t h) {
+            const auto ow = w / 2, oh = h / 2;
+            std::vector<float32_t> out(ow * oh * Channels);
+            const auto bands = force::detail::band_count(oh, quality_min_elements / (ow * Channels + 1) + 1);
+            force::detail::for_each_band(oh, bands, [&](std::size_t, std::size_t beg, std::size_t end) {
+                for (auto y = beg; y != end; ++y) {
+                    const float32_t* r0 = in.data() + 2 * y * w * Channels;
+                    const float32_t* r1 = r0 + w * Channels;
+                    float32_t*       d  = out.data() + y * ow * Channels;
+                    for (std::size_t x = 0; x != ow; ++x) {
+                        for (std::size_t c = 0; c != Channels; ++c) {
+                            const auto i = 2 * x * Channels + c;
+                            d[x * Channels + c] = 0.25f * ((r0[i] + r0[i + Channels]) + (r1[i] + r1[i + Channels]));
+                        }
+                    }
+                }
+            });
+            return out;
+        }
+    }
+
+    /// \brief  Mean squared error of every channel.
+    template <interleaved_pixel_concept Pix>
+    channel_scores_t<Pix> mse_view(const matrix_view<Pix> a, const matrix_view<Pix> b) {
+        detail::check_quality_views(a, b);
+        return detail::mean_squared_error(a, b);
+    }
+    /// \brief  Peak signal to noise ratio in dB of every channel, infinity where the channel is identical.
+    /// \example
+    /// auto psnr = psnr_view(reference, decoded);
+    /// auto luma = psnr[0];
+    template <interleaved_pixel_concept Pix>
+    channel_scores_t<Pix> psnr_view(const matrix_view<Pix> a, const matrix_view<Pix> b) {
+        constexpr auto peak = detail::quality_peak<typename Pix::value_type>();
+        auto scores = mse_view(a, b);
+        for (auto& v : scores) { v = v == 0.0 ? std::numeric_limits<float64_t>::infinity() : 10.0 * std::log10(peak * peak / v); }
+        return scores;
+    }
+    /// \brief  Mean structural similarity of every channel, 1 for identical images.
+    template <interleaved_pixel_concept Pix>
+    channel_scores_t<Pix> ssim_view(const matrix_view<Pix> a, const matrix_view<Pix> b, const ssim_window window = ssim_window::gaussian) {
+        constexpr auto channels = detail::pixel_channels_v<Pix>;
+        detail::check_quality_views(a, b);
+        const auto taps = detail::ssim_taps(window);
+        if (a.width() < taps.size() || a.height() < taps.size()) throw std::runtime_error("Views are smaller than the SSIM window!");
+        const auto sums = detail::ssim_pass<channels>(a.width(), a.height(), taps, detail::quality_peak<typename Pix::value_type>(), detail::ssim_view_loader(a, b));
+        channel_scores_t<Pix> scores;
+        for (std::size_t c = 0; c != channels; ++c) { scores[c] = sums.ssim[c] / static_cast<float64_t>(sums.count); }
+        return scores;
+    }
+    /// \brief  Multi-scale structural similarity of every channel over five scales.
+    template <interleaved_pixel_concept Pix>
+    channel_scores_t<Pix> ms_ssim_view(const matrix_view<Pix> a, const matrix_view<Pix> b, const ssim_window window = ssim_window::gaussian) {
+        constexpr auto channels = detail::pixel_channels_v<Pix>;
+        constexpr std::array<float64_t, 5> weights = { 0.0448, 0.2856, 0.3001, 0.2363, 0.1333 };
+        detail::check_quality_views(a, b);
+        const auto taps = detail::ssim_taps(window);
+        const auto min  = taps.size() << (weights.size() - 1);
+        if (a.width() < min || a.height() < min) throw std::runtime_error("Views are too small for MS-SSIM!");
+        const auto peak = detail::quality_peak<typename Pix::value_type>();
+
+        auto w = a.width(), h = a.height();
+        std::vector<float32_t> fa(w * h * channels), fb(w * h * channels);
+        const auto bands = force::detail::band_count(h, detail::quality_min_elements / (w * channels) + 1);
+        force::detail::for_each_band(h, bands, [&, load = detail::ssim_view_loader(a, b)](std::size_t, std::size_t beg, std::size_t end) {
+            for (auto y = beg; y != end; ++y) { load(y, fa.data() + y * w * channels, fb.data() + y * w * channels); }
+        });
+
+        channel_scores_t<Pix> scores;
+        scores.fill(1.0);
+        for (std::size_t s = 0; s != weights.size(); ++s) {
+            const auto sums = detail::ssim_pass<channels>(w, h, taps, peak, [&, w](std::size_t y, float32_t* ra, float32_t* rb) {
+                std::copy_n(fa.data() + y * w * channels, w * channels, ra);
+                std::copy_n(fb.data() + y * w * channels, w * channels, rb);
+            });
+            const bool last = s + 1 == weights.size();
+            for (std::size_t c = 0; c != channels; ++c) {
+                // Negative contrast-structure means anti-correlated content, count it as no similarity.
+                const auto v = std::max(0.0, (last ? sums.ssim[c] : sums.cs[c]) / static_cast<float64_t>(sums.count));
+                scores[c] *= std::pow(v, weights[s]);
+            }
+            if (last) break;
+            fa = detail::ssim_downsample<channels>(fa, w, h);
+            fb = detail::ssim_downsample<channels>(fb, w, h);
+            w /= 2;
+            h /= 2;
+        }
+        return scores;
+    }
+}
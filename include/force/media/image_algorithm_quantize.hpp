@@ -0,0 +1,419 @@
+///
+/// \file      image_algorithm_quantize.hpp
+/// \brief     Colour quantization (palette building), nearest colour lookup and dithering.
+/// \details
+///
+/// Turning a true colour image into an indexed one is done in three steps:
+/// 1. Build a palette, median_cut_palette or octree_palette. Both work on a joint histogram instead of
+///    the pixels themselves, so the expensive part is the (parallel) histogram.
+/// 2. Build an inverse_palette, a 32x32x32 table mapping a colour to its nearest palette entry, which
+///    turns every later lookup into a single load.
+/// 3. Map the image: remap_view (no dithering), dither_ordered_view (Bayer matrix, every pixel is
+///    independent) or dither_floyd_steinberg_view (error diffusion).
+///
+/// Floyd-Steinberg makes every pixel depend on its left neighbour and on 3 pixels of the previous row.
+/// With a raster scan rows can still run in parallel as a wavefront, a row only has to stay two pixels
+/// behind the row above. A serpentine scan flips direction every row, so a row can't start before
+/// the previous one is finished and serpentine is always processed on one thread.
+///
+/// Only 3 channel 8bit pixels are supported, palette indices are written into grey_u8 views.
+///
+/// \author    HenryDu
+/// \date      18.10.2026
+/// \copyright © HenryDu 2026. All right reserved.
+///
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "force/execution.hpp"
+#include "force/media/image_algorithm_histogram.hpp"
+
+namespace force::media {
+    template <typename Pix>
+    concept quantizable_pixel_concept = interleaved_pixel_concept<Pix> &&
+                                        std::is_same_v<typename Pix::value_type, std::uint8_t> &&
+                                        (detail::pixel_channels_v<Pix> == 3);
+
+    template <quantizable_pixel_concept Pix>
+    using image_palette = std::vector<Pix>;
+
+    enum class error_diffusion_scan {
+        raster,     // Left to right on every row, rows run in parallel as a wavefront.
+        serpentine  // Alternate direction every row, less directional artifacts but single threaded.
+    };
+
+    namespace detail {
+        constexpr std::size_t quantize_min_rows = 16;
+
+        template <quantizable_pixel_concept Pix>
+        constexpr Pix make_palette_pixel(const std::uint64_t c0, const std::uint64_t c1, const std::uint64_t c2) {
+            Pix p;
+            p[0] = static_cast<std::uint8_t>(c0);
+            p[1] = static_cast<std::uint8_t>(c1);
+            p[2] = static_cast<std::uint8_t>(c2);
+            return p;
+        }
+        template <typename Pix>
+        void check_quantize_size(const matrix_view<Pix>& src, const matrix_view<grey_u8_pixel_t>& dest) {
+            if (src.width() != dest.width() || src.height() != dest.height()) throw std::runtime_error("Source and index map size mismatch!");
+        }
+        // Box in a joint histogram with Bits per channel, bounds are inclusive cell coordinates.
+        struct median_cut_box {
+            std::array<std::size_t, 3> lo, hi;
+            std::size_t                count;
+        };
+        template <std::size_t Bits>
+        constexpr std::size_t joint_index(const std::size_t c0, const std::size_t c1, const std::size_t c2) {
+            return (c0 << (2 * Bits)) | (c1 << Bits) | c2;
+        }
+        // Shrinks the box to its non-empty cells and recounts it.
+        template <std::size_t Bits>
+        void median_cut_shrink(median_cut_box& box, const std::vector<std::size_t>& hist) {
+            std::array<std::size_t, 3> lo = box.hi, hi = box.lo;
+            box.count = 0;
+            for (auto i = box.lo[0]; i <= box.hi[0]; ++i) {
+                for (auto j = box.lo[1]; j <= box.hi[1]; ++j) {
+                    for (auto k = box.lo[2]; k <= box.hi[2]; ++k) {
+                        auto n = hist[joint_index<Bits>(i, j, k)];
+                        if (n == 0) continue;
+                        box.count += n;
+                        lo = { std::min(lo[0], i), std::min(lo[1], j), std::min(lo[2], k) };
+                        hi = { std::max(hi[0], i), std::max(hi[1], j), std::max(hi[2], k) };
+                    }
+                }
+            }
+            if (box.count != 0) { box.lo = lo; box.hi = hi; }
+        }
+    }
+
+    /// \brief  Median cut palette: recursively split the most populated, widest box of the colour cube at its median.
+    /// \param  view    - Source image.
+    /// \param  colours - Palette size, at most 256.
+    /// \retval         - Palette with at most colours entries (fewer if the image has fewer distinct colours).
+    template <quantizable_pixel_concept Pix>
+    image_palette<Pix> median_cut_palette(const matrix_view<Pix> view, const std::size_t colours) {
+        constexpr std::size_t bits  = 5;
+        constexpr std::size_t cells = std::size_t(1) << bits;
+        auto hist = joint_histogram_view<bits>(view);
+
+        std::vector<detail::median_cut_box> boxes;
+        boxes.push_back({ { 0, 0, 0 }, { cells - 1, cells - 1, cells - 1 }, 0 });
+        detail::median_cut_shrink<bits>(boxes.back(), hist);
+        if (boxes.back().count == 0) { return {}; }
+
+        auto longest_axis = [](const detail::median_cut_box& b) {
+            std::size_t axis = 0;
+            for (std::size_t a = 1; a != 3; ++a) { if (b.hi[a] - b.lo[a] > b.hi[axis] - b.lo[axis]) axis = a; }
+            return axis;
+        };
+        while (boxes.size() < std::min<std::size_t>(colours, 256)) {
+            // Priority is population times extent, single cell boxes can't be split.
+            std::size_t best = boxes.size();
+            std::size_t best_score = 0;
+            for (std::size_t i = 0; i != boxes.size(); ++i) {
+                auto& b = boxes[i];
+                auto extent = b.hi[longest_axis(b)] - b.lo[longest_axis(b)];
+                if (extent == 0) continue;
+                auto score = b.count * extent;
+                if (score > best_score) { best_score = score; best = i; }
+            }
+            if (best == boxes.size()) break;
+
+            auto box  = boxes[best];
+            auto axis = longest_axis(box);
+            // Population of every slice along the axis.
+            std::array<std::size_t, cells> slice{};
+            for (auto i = box.lo[0]; i <= box.hi[0]; ++i) {
+                for (auto j = box.lo[1]; j <= box.hi[1]; ++j) {
+                    for (auto k = box.lo[2]; k <= box.hi[2]; ++k) {
+                        std::array<std::size_t, 3> c{ i, j, k };
+                        slice[c[axis]] += hist[detail::joint_index<bits>(i, j, k)];
+                    }
+                }
+            }
+            // Median slice, both halves must keep at least one slice.
+            std::size_t acc = 0, cut = box.lo[axis];
+            for (; cut < box.hi[axis] - 1; ++cut) {
+                acc += slice[cut];
+                if (acc * 2 >= box.count) break;
+            }
+            auto a = box, b = box;
+            a.hi[axis] = cut;
+            b.lo[axis] = cut + 1;
+            detail::median_cut_shrink<bits>(a, hist);
+            detail::median_cut_shrink<bits>(b, hist);
+            boxes[best] = a;
+            boxes.push_back(b);
+        }
+        // Weighted mean of cell centres.
+        image_palette<Pix> palette;
+        palette.reserve(boxes.size());
+        for (auto& box : boxes) {
+            std::array<std::uint64_t, 3> sum{};
+            for (auto i = box.lo[0]; i <= box.hi[0]; ++i) {
+                for (auto j = box.lo[1]; j <= box.hi[1]; ++j) {
+                    for (auto k = box.lo[2]; k <= box.hi[2]; ++k) {
+                        auto n = hist[detail::joint_index<bits>(i, j, k)];
+                        sum[0] += n * ((i << (8 - bits)) + (1 << (7 - bits)));
+                        sum[1] += n * ((j << (8 - bits)) + (1 << (7 - bits)));
+                        sum[2] += n * ((k << (8 - bits)) + (1 << (7 - bits)));
+                    }
+                }
+            }
+            palette.push_back(detail::make_palette_pixel<Pix>(sum[0] / box.count, sum[1] / box.count, sum[2] / box.count));
+        }
+        return palette;
+    }
+
+    /// \brief  Octree palette: every colour is a path in an octree, the least populated deepest nodes are merged
+    ///         into their parents until only colours leaves are left.
+    template <quantizable_pixel_concept Pix>
+    image_palette<Pix> octree_palette(const matrix_view<Pix> view, const std::size_t colours) {
+        constexpr std::size_t bits = 6;
+        struct node {
+            std::size_t                  count = 0;
+            std::array<std::uint64_t, 3> sum{};
+            std::array<std::int32_t, 8>  child{ -1, -1, -1, -1, -1, -1, -1, -1 };
+            bool                         leaf = false;
+        };
+        auto hist = joint_histogram_view<bits>(view);
+
+        std::vector<node>                                      nodes(1);
+        std::array<std::vector<std::int32_t>, bits>            levels; // Inner nodes per depth.
+        std::size_t                                            leaves = 0;
+        levels[0].push_back(0);
+        for (std::size_t key = 0; key != hist.size(); ++key) {
+            auto n = hist[key];
+            if (n == 0) continue;
+            std::array<std::uint64_t, 3> c{ key >> (2 * bits), (key >> bits) & ((1 << bits) - 1), key & ((1 << bits) - 1) };
+            std::int32_t cur = 0;
+            for (std::size_t depth = 0; depth != bits; ++depth) {
+                auto s      = bits - 1 - depth;
+                auto branch = (((c[0] >> s) & 1) << 2) | (((c[1] >> s) & 1) << 1) | ((c[2] >> s) & 1);
+                if (nodes[cur].child[branch] < 0) {
+                    auto id = static_cast<std::int32_t>(nodes.size());
+                    nodes[cur].child[branch] = id;
+                    nodes.emplace_back();
+                    if (depth + 1 == bits) { nodes.back().leaf = true; ++leaves; }
+                    else                   { levels[depth + 1].push_back(id); }
+                }
+                cur = nodes[cur].child[branch];
+            }
+            nodes[cur].count += n;
+            for (std::size_t i = 0; i != 3; ++i) { nodes[cur].sum[i] += n * ((c[i] << (8 - bits)) + (1 << (7 - bits))); }
+        }
+        // Subtree populations are needed to pick which node to merge.
+        for (std::size_t depth = bits; depth-- > 0;) {
+            for (auto id : levels[depth]) {
+                for (auto ch : nodes[id].child) { if (ch >= 0) nodes[id].count += nodes[ch].count; }
+            }
+        }
+        auto target = std::max<std::size_t>(1, std::min<std::size_t>(colours, 256));
+        for (std::size_t depth = bits; depth-- > 0 && leaves > target;) {
+            auto& level = levels[depth];
+            std::sort(level.begin(), level.end(), [&nodes](auto a, auto b) { return nodes[a].count < nodes[b].count; });
+            for (auto id : level) {
+                if (leaves <= target) break;
+                auto& p = nodes[id];
+                std::size_t merged = 0;
+                for (auto& ch : p.child) {
+                    if (ch < 0) continue;
+                    for (std::size_t i = 0; i != 3; ++i) { p.sum[i] += nodes[ch].sum[i]; }
+                    nodes[ch].leaf = false;
+                    ch = -1;
+                    ++merged;
+                }
+                p.leaf = true;
+                leaves = leaves + 1 - merged;
+            }
+        }
+        image_palette<Pix> palette;
+        palette.reserve(leaves);
+        for (auto& n : nodes) {
+            if (!n.leaf || n.count == 0) continue;
+            palette.push_back(detail::make_palette_pixel<Pix>(n.sum[0] / n.count, n.sum[1] / n.count, n.sum[2] / n.count));
+        }
+        return palette;
+    }
+
+    ///
+    /// \class   inverse_palette
+    /// \brief   Nearest palette entry of every cell of a 32x32x32 colour cube, lookup is one load.
+    /// \tparam  Pix - Palette pixel type.
+    ///
+    template <quantizable_pixel_concept Pix>
+    class inverse_palette {
+    public:
+        static constexpr std::size_t bits  = 5;
+        static constexpr std::size_t cells = std::size_t(1) << bits;
+
+        explicit inverse_palette(const image_palette<Pix>& palette) : mTable(cells * cells * cells, 0) {
+            if (palette.empty())      throw std::runtime_error("Palette is empty!");
+            if (palette.size() > 256) throw std::runtime_error("Palette has more than 256 entries!");
+            for (std::size_t i = 0; i != cells; ++i) {
+                for (std::size_t j = 0; j != cells; ++j) {
+                    for (std::size_t k = 0; k != cells; ++k) {
+                        std::int32_t c[3] = { cell_centre(i), cell_centre(j), cell_centre(k) };
+                        std::int32_t best_d = std::numeric_limits<std::int32_t>::max();
+                        for (std::size_t p = 0; p != palette.size(); ++p) {
+                            std::int32_t d = 0;
+                            for (std::size_t ch = 0; ch != 3; ++ch) { d += square(c[ch] - static_cast<std::int32_t>(palette[p][ch])); }
+                            if (d < best_d) { best_d = d; mTable[detail::joint_index<bits>(i, j, k)] = static_cast<std::uint8_t>(p); }
+                        }
+                    }
+                }
+            }
+        }
+        constexpr std::uint8_t operator()(const std::int32_t c0, const std::int32_t c1, const std::int32_t c2) const {
+            return mTable[detail::joint_index<bits>(c0 >> (8 - bits), c1 >> (8 - bits), c2 >> (8 - bits))];
+        }
+        constexpr std::uint8_t operator()(const Pix& p) const { return operator()(p[0], p[1], p[2]); }
+    private:
+        static constexpr std::int32_t cell_centre(const std::size_t i) { return static_cast<std::int32_t>((i << (8 - bits)) + (1 << (7 - bits))); }
+        std::vector<std::uint8_t> mTable;
+    };
+
+    /// \brief  Map every pixel to its nearest palette entry without dithering.
+    template <quantizable_pixel_concept Pix>
+    void remap_view(const matrix_view<Pix> src, const inverse_palette<Pix>& inverse, matrix_view<grey_u8_pixel_t> dest) {
+        detail::check_quantize_size(src, dest);
+        force::detail::for_each_band(src.height(), force::detail::band_count(src.height(), detail::quantize_min_rows),
+            [&](std::size_t, std::size_t beg, std::size_t end) {
+            for (auto y = beg; y != end; ++y) {
+                auto sr = src.row_at(y);
+                auto dr = dest.row_at(y);
+                for (std::size_t x = 0; x != src.width(); ++x) { dr[x][0] = inverse(sr[x]); }
+            }
+        });
+    }
+    /// \brief  Ordered (8x8 Bayer) dithering, pixels are independent so rows run in parallel.
+    /// \param  spread - Amplitude of the threshold pattern in 8bit units, roughly the distance between palette colours.
+    template <quantizable_pixel_concept Pix>
+    void dither_ordered_view(const matrix_view<Pix> src, const inverse_palette<Pix>& inverse, matrix_view<grey_u8_pixel_t> dest, const float32_t spread = 32.F) {
+        detail::check_quantize_size(src, dest);
+        static constexpr std::uint8_t bayer[8][8] = {
+            {  0, 32,  8, 40,  2, 34, 10, 42 }, { 48, 16, 56, 24, 50, 18, 58, 26 },
+            { 12, 44,  4, 36, 14, 46,  6, 38 }, { 60, 28, 52, 20, 62, 30, 54, 22 },
+            {  3, 35, 11, 43,  1, 33,  9, 41 }, { 51, 19, 59, 27, 49, 17, 57, 25 },
+            { 15, 47,  7, 39, 13, 45,  5, 37 }, { 63, 31, 55, 23, 61, 29, 53, 21 },
+        };
+        // Offsets of the 8 columns of every Bayer row, centred on 0.
+        std::array<std::array<std::int32_t, 8>, 8> offset;
+        for (std::size_t i = 0; i != 8; ++i) {
+            for (std::size_t j = 0; j != 8; ++j) {
+                offset[i][j] = static_cast<std::int32_t>(((static_cast<float32_t>(bayer[i][j]) + 0.5F) / 64.F - 0.5F) * spread);
+            }
+        }
+        force::detail::for_each_band(src.height(), force::detail::band_count(src.height(), detail::quantize_min_rows),
+            [&](std::size_t, std::size_t beg, std::size_t end) {
+            for (auto y = beg; y != end; ++y) {
+                auto  sr = src.row_at(y);
+                auto  dr = dest.row_at(y);
+                auto& o  = offset[y & 7];
+                for (std::size_t x = 0; x != src.width(); ++x) {
+                    const Pix& p = sr[x];
+                    auto k = o[x & 7];
+                    dr[x][0] = inverse(clamp(p[0] + k, 0, 255), clamp(p[1] + k, 0, 255), clamp(p[2] + k, 0, 255));
+                }
+            }
+        });
+    }
+
+    namespace detail {
+        // Error rows hold (width + 2) * 3 errors in 1/16 units, one guard pixel on each side.
+        // The error pushed to the right neighbour never touches memory so that a row only reads what the
+        // previous row wrote, which is what makes the wavefront race free.
+        template <quantizable_pixel_concept Pix, typename SrcRow, typename DstRow>
+        void floyd_steinberg_span(const SrcRow& src, const image_palette<Pix>& palette,
+                                  const inverse_palette<Pix>& inverse, DstRow& dest,
+                                  const std::int32_t* cur, std::int32_t* next, std::array<std::int32_t, 3>& carry,
+                                  std::ptrdiff_t beg, std::ptrdiff_t end, std::ptrdiff_t dir) {
+            for (auto x = beg; x != end; x += dir) {
+                const Pix& p = src[x];
+                std::int32_t c[3];
+                for (std::size_t ch = 0; ch != 3; ++ch) {
+                    auto e = cur[(x + 1) * 3 + ch] + carry[ch];
+                    c[ch] = clamp<std::int32_t>(static_cast<std::int32_t>(p[ch]) + ((e + 8) >> 4), 0, 255);
+                }
+                auto index = inverse(c[0], c[1], c[2]);
+                dest[x][0] = index;
+                for (std::size_t ch = 0; ch != 3; ++ch) {
+                    auto e = c[ch] - static_cast<std::int32_t>(palette[index][ch]);
+                    carry[ch] = e * 7;
+                    next[(x + 1 - dir) * 3 + ch] += e * 3;
+                    next[(x + 1)       * 3 + ch] += e * 5;
+                    next[(x + 1 + dir) * 3 + ch] += e;
+                }
+            }
+        }
+    }
+    /// \brief  Floyd-Steinberg error diffusion dithering.
+    /// \param  scan - raster runs rows as a parallel wavefront, serpentine is single threaded.
+    template <quantizable_pixel_concept Pix>
+    void dither_floyd_steinberg_view(const matrix_view<Pix> src, const image_palette<Pix>& palette, const inverse_palette<Pix>& inverse,
+                                     matrix_view<grey_u8_pixel_t> dest, const error_diffusion_scan scan = error_diffusion_scan::raster) {
+        detail::check_quantize_size(src, dest);
+        const auto w = static_cast<std::ptrdiff_t>(src.width());
+        const auto h = src.height();
+        const auto row_size = static_cast<std::size_t>(w + 2) * 3;
+        const auto threads  = scan == error_diffusion_scan::serpentine ? std::size_t(1) : force::detail::band_count(h, detail::quantize_min_rows);
+
+        if (threads == 1) {
+            std::vector<std::int32_t> err(row_size * 2, 0);
+            for (std::size_t y = 0; y != h; ++y) {
+                auto* cur  = err.data() + (y & 1) * row_size;
+                auto* next = err.data() + ((y + 1) & 1) * row_size;
+                std::fill_n(next, row_size, 0);
+                auto sr = src.row_at(y);
+                auto dr = dest.row_at(y);
+                std::array<std::int32_t, 3> carry{};
+                bool backward = scan == error_diffusion_scan::serpentine && (y & 1);
+                detail::floyd_steinberg_span(sr, palette, inverse, dr, cur, next, carry, backward ? w - 1 : 0, backward ? -1 : w, backward ? -1 : 1);
+            }
+            return;
+        }
+        // Wavefront: thread t runs rows t, t + threads, ... A row waits until the row above is two pixels ahead,
+        // error rows live in a ring of (threads + 2) slots and a slot is reused only once its reader is done.
+        // Every worker must be running at the same time, so they are plain threads rather than pooled bands.
+        constexpr std::ptrdiff_t chunk = 64;
+        const auto slots = threads + 2;
+        std::vector<std::int32_t>             err(row_size * slots, 0);
+        std::vector<std::atomic<std::ptrdiff_t>> progress(h);
+        for (auto& p : progress) { p.store(0, std::memory_order_relaxed); }
+
+        auto wait_for = [&progress](std::size_t row, std::ptrdiff_t x) {
+            while (progress[row].load(std::memory_order_acquire) < x) { std::this_thread::yield(); }
+        };
+        auto worker = [&](std::size_t t) {
+            for (auto y = t; y < h; y += threads) {
+                auto* cur  = err.data() + (y % slots) * row_size;
+                auto* next = err.data() + ((y + 1) % slots) * row_size;
+                // The next slot was last read by row y + 1 - slots.
+                if (y + 1 >= slots) { wait_for(y + 1 - slots, w); }
+                std::fill_n(next, row_size, 0);
+                auto sr = src.row_at(y);
+                auto dr = dest.row_at(y);
+                std::array<std::int32_t, 3> carry{};
+                for (std::ptrdiff_t x = 0; x < w; x += chunk) {
+                    auto end = std::min(x + chunk, w);
+                    // Error for pixel x is complete once the row above has processed x + 1.
+                    if (y != 0) { wait_for(y - 1, std::min(end + 1, w)); }
+                    detail::floyd_steinberg_span(sr, palette, inverse, dr, cur, next, carry, x, end, 1);
+                    progress[y].store(end, std::memory_order_release);
+                }
+                if (w == 0) { progress[y].store(0, std::memory_order_release); }
+            }
+        };
+        {
+            std::vector<std::jthread> workers;
+            for (std::size_t t = 1; t < threads; ++t) { workers.emplace_back(worker, t); }
+            worker(0);
+        }
+    }
+}
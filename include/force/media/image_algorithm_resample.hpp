@@ -0,0 +1,266 @@
+///
+/// \file      image_algorithm_resample.hpp
+/// \brief     Separable high quality resampling (box/area, bilinear, bicubic, Lanczos-3).
+/// \details
+///
+/// Resampling is done in two 1D passes: horizontal into an intermediate buffer, then vertical into the
+/// destination. Weights are computed once per call for every destination column and row. Integer pixels
+/// use Q14 fixed point weights, floating point pixels use float weights. When downscaling the filter is
+/// widened by the scale factor, so every source pixel contributes (no aliasing) and box becomes an exact
+/// area average.
+///
+/// Both passes run over contiguous channel arrays. The vertical pass in particular is a weighted sum of
+/// whole rows, which vectorizes well. Rows of both passes are split into bands and run on several threads.
+///
+/// The intermediate buffer keeps the overshoot of bicubic and Lanczos and extra precision: 8bit pixels
+/// are stored as Q6 int16, wider integers unrounded and unclamped, and values are clamped only when the
+/// destination is written.
+///
+/// A transfer stage can be fused into the passes: direct_transfer resamples the stored values,
+/// srgb_transfer decodes 8bit sRGB to float linear light on read and encodes back on write, so the
+/// filter averages light instead of gamma encoded values. The alpha channel, if any, stays linear.
+///
+/// \author    HenryDu
+/// \date      18.10.2026
+/// \copyright © HenryDu 2026. All right reserved.
+///
+#pragma once
+
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "force/execution.hpp"
+#include "force/media/image_algorithm_gamma.hpp"
+
+namespace force::media {
+    enum class resample_filter {
+        box,       // Area average when downscaling, nearest when upscaling.
+        bilinear,  // Triangle, radius 1.
+        bicubic,   // Keys cubic (a = -0.5), radius 2.
+        lanczos3   // Windowed sinc, radius 3.
+    };
+
+    // Resample stored values as they are.
+    struct direct_transfer {
+        template <typename Ty>
+        using work_type = Ty;
+        template <typename Ty>
+        static constexpr Ty decode(const Ty v, bool) { return v; }
+        template <typename Ty, typename Work>
+        static constexpr Ty encode(const Work v, bool) { return static_cast<Ty>(v); }
+    };
+    // 8bit sRGB in and out, resampled as float linear light. Alpha is linear already, it is only rescaled.
+    struct srgb_transfer {
+        template <typename Ty>
+        using work_type = float32_t;
+        static float32_t decode(const std::uint8_t v, const bool alpha) {
+            return alpha ? static_cast<float32_t>(v) * (1.F / 255.F) : srgb_to_linear(v);
+        }
+        template <typename Ty>
+        static Ty encode(const float32_t v, const bool alpha) {
+            return alpha ? static_cast<Ty>(clamp(v, 0.F, 1.F) * 255.F + 0.5F) : linear_to_srgb(v);
+        }
+    };
+
+    namespace detail {
+        constexpr std::size_t resample_min_pixels   = 1 << 15;
+        constexpr std::int32_t resample_weight_bits = 14;
+
+        inline float64_t resample_kernel(const resample_filter filter, const float64_t x) {
+            auto a = x < 0 ? -x : x;
+            switch (filter) {
+            case resample_filter::box:      return a < 0.5 ? 1.0 : (a == 0.5 ? 0.5 : 0.0);
+            case resample_filter::bilinear: return a < 1.0 ? 1.0 - a : 0.0;
+            case resample_filter::bicubic: {
+                constexpr float64_t k = -0.5;
+                if (a < 1.0) { return ((k + 2.0) * a - (k + 3.0)) * a * a + 1.0; }
+                if (a < 2.0) { return (((a - 5.0) * a + 8.0) * a - 4.0) * k; }
+                return 0.0;
+            }
+            case resample_filter::lanczos3: {
+                if (a < 1e-8) { return 1.0; }
+                if (a >= 3.0) { return 0.0; }
+                auto p = pi_v<float64_t> * a;
+                return 3.0 * std::sin(p) * std::sin(p / 3.0) / (p * p);
+            }
+            }
+            return 0.0;
+        }
+        inline float64_t resample_radius(const resample_filter filter) {
+            switch (filter) {
+            case resample_filter::box:      return 0.5;
+            case resample_filter::bilinear: return 1.0;
+            case resample_filter::bicubic:  return 2.0;
+            case resample_filter::lanczos3: return 3.0;
+            }
+            return 1.0;
+        }
+        /// \brief Weights of one resampling axis: destination i reads source [offset[i], offset[i] + taps)
+        ///        with weights coeff[i * taps, (i + 1) * taps). Taps past the source edge have zero weight.
+        template <typename Weight>
+        struct resample_weights {
+            std::vector<std::size_t> offset;
+            std::vector<Weight>      coeff;
+            std::size_t              taps;
+        };
+        template <typename Weight>
+        resample_weights<Weight> make_resample_weights(const std::size_t src, const std::size_t dst, const resample_filter filter) {
+            const auto scale   = static_cast<float64_t>(src) / static_cast<float64_t>(dst);
+            const auto stretch = scale > 1.0 ? scale : 1.0;
+            const auto support = resample_radius(filter) * stretch;
+            const auto taps    = std::min(static_cast<std::size_t>(std::ceil(support)) * 2 + 1, src);
+
+            resample_weights<Weight> w{ std::vector<std::size_t>(dst), std::vector<Weight>(dst * taps, Weight(0)), taps };
+            std::vector<float64_t> f(taps);
+            for (std::size_t i = 0; i != dst; ++i) {
+                auto centre = (static_cast<float64_t>(i) + 0.5) * scale;
+                auto lo     = static_cast<std::ptrdiff_t>(std::floor(centre - support + 0.5));
+                auto hi     = static_cast<std::ptrdiff_t>(std::floor(centre + support + 0.5));
+                lo = std::max<std::ptrdiff_t>(lo, 0);
+                hi = std::min<std::ptrdiff_t>(hi, static_cast<std::ptrdiff_t>(src));
+                // Keep the window inside the source so that every window has exactly taps entries.
+                auto first = std::min<std::ptrdiff_t>(lo, static_cast<std::ptrdiff_t>(src - taps));
+                hi = std::min<std::ptrdiff_t>(hi, first + static_cast<std::ptrdiff_t>(taps));
+                float64_t sum = 0.0;
+                for (std::size_t k = 0; k != taps; ++k) {
+                    auto j = first + static_cast<std::ptrdiff_t>(k);
+                    f[k] = (j >= lo && j < hi) ? resample_kernel(filter, (static_cast<float64_t>(j) + 0.5 - centre) / stretch) : 0.0;
+                    sum += f[k];
+                }
+                if (sum == 0.0) {
+                    // Only happens for box upscaling exactly between two pixels, take the nearest.
+                    auto n = std::clamp<std::ptrdiff_t>(static_cast<std::ptrdiff_t>(centre), 0, src - 1) - first;
+                    f[n] = sum = 1.0;
+                }
+                w.offset[i] = static_cast<std::size_t>(first);
+                auto* c = w.coeff.data() + i * taps;
+                if constexpr (std::is_floating_point_v<Weight>) {
+                    for (std::size_t k = 0; k != taps; ++k) { c[k] = static_cast<Weight>(f[k] / sum); }
+                }
+                else {
+                    // Rounded weights must still add up to exactly one, the rounding error goes into the largest.
+                    constexpr auto one = Weight(1) << resample_weight_bits;
+                    Weight total = 0;
+                    std::size_t largest = 0;
+                    for (std::size_t k = 0; k != taps; ++k) {
+                        c[k] = static_cast<Weight>(std::lround(f[k] / sum * one));
+                        total += c[k];
+                        if (c[k] > c[largest]) largest = k;
+                    }
+                    c[largest] += one - total;
+                }
+            }
+            return w;
+        }
+
+        template <typename Work>
+        using resample_weight_t = std::conditional_t<std::is_floating_point_v<Work>, float32_t, std::int32_t>;
+        template <typename Work>
+        using resample_accumulator_t = std::conditional_t<std::is_floating_point_v<Work>, float32_t,
+                                       std::conditional_t<(sizeof(Work) < 2), std::int32_t, std::int64_t>>;
+        // Intermediate (horizontal pass) values, signed and wide enough for filter overshoot. 8bit values
+        // keep resample_middle_bits fraction bits, about +-511 levels fit in int16.
+        template <typename Work>
+        using resample_middle_t = std::conditional_t<std::is_floating_point_v<Work>, float32_t,
+                                  std::conditional_t<(sizeof(Work) < 2), std::int16_t,
+                                  std::conditional_t<(sizeof(Work) < 4), std::int32_t, std::int64_t>>>;
+        template <typename Work>
+        constexpr std::int32_t resample_middle_bits = std::is_floating_point_v<Work> || sizeof(Work) >= 2 ? 0 : 6;
+
+        // Rounded acc >> bits, for floats acc itself.
+        template <typename Out, typename Acc>
+        constexpr Out resample_shift(const Acc acc, const std::int32_t bits) {
+            if constexpr (std::is_floating_point_v<Acc>) { return static_cast<Out>(acc); }
+            else {
+                auto v = (acc + (Acc(1) << (bits - 1))) >> bits;
+                return static_cast<Out>(clamp<Acc>(v, Acc(std::numeric_limits<Out>::min()), Acc(std::numeric_limits<Out>::max())));
+            }
+        }
+    }
+
+    /// \brief  Resample src into dest (of any size) with a separable filter.
+    /// \tparam Transfer      - direct_transfer or srgb_transfer (8bit pixels only).
+    /// \param  src           - Source view, any interleaved pixel.
+    /// \param  dest          - Destination view, same value_type and channel count as src.
+    /// \param  filter        - Reconstruction filter.
+    /// \param  alpha_channel - Channel index of alpha, the transfer leaves it linear. Negative if there is none.
+    /// \example
+    /// // Gamma correct thumbnail.
+    /// resample_view<srgb_transfer>(photo, thumbnail, resample_filter::lanczos3);
+    template <typename Transfer = direct_transfer, interleaved_pixel_concept SrcPix, interleaved_pixel_concept DstPix>
+        requires std::is_same_v<typename SrcPix::value_type, typename DstPix::value_type>
+    void resample_view(const matrix_view<SrcPix> src, matrix_view<DstPix> dest, const resample_filter filter = resample_filter::bilinear,
+                       const std::ptrdiff_t alpha_channel = -1) {
+        using value_t  = typename SrcPix::value_type;
+        using work_t   = typename Transfer::template work_type<value_t>;
+        using weight_t = detail::resample_weight_t<work_t>;
+        using acc_t    = detail::resample_accumulator_t<work_t>;
+        using middle_t = detail::resample_middle_t<work_t>;
+        constexpr auto middle_bits = detail::resample_middle_bits<work_t>;
+        static_assert(detail::pixel_channels_v<SrcPix> == detail::pixel_channels_v<DstPix>, "Channel count mismatch!");
+        static_assert(!std::is_same_v<Transfer, srgb_transfer> || std::is_same_v<value_t, std::uint8_t>, "srgb_transfer needs 8bit pixels!");
+        constexpr auto channels = detail::pixel_channels_v<SrcPix>;
+
+        const auto sw = src.width(), sh = src.height(), dw = dest.width(), dh = dest.height();
+        if (sw == 0 || sh == 0 || dw == 0 || dh == 0) return;
+
+        const auto hw = detail::make_resample_weights<weight_t>(sw, dw, filter);
+        const auto vw = detail::make_resample_weights<weight_t>(sh, dh, filter);
+        // Only source rows some destination row reads go through the horizontal pass.
+        const auto row_beg = vw.offset.front();
+        const auto row_end = vw.offset.back() + vw.taps;
+        const auto stride  = dw * channels;
+        std::vector<middle_t> middle(stride * (row_end - row_beg));
+
+        // Horizontal pass: source rows -> middle.
+        auto bands = force::detail::band_count(row_end - row_beg, detail::resample_min_pixels / (sw + dw) + 1);
+        force::detail::for_each_band(row_end - row_beg, bands, [&](std::size_t, std::size_t beg, std::size_t end) {
+            std::vector<value_t> raw(sw * channels);
+            std::vector<work_t>  line(sw * channels);
+            for (auto r = beg; r != end; ++r) {
+                auto y = row_beg + r;
+                // Gather one source row (from strided and packed pixels too) and decode it.
+                detail::read_channel_row(src, static_cast<std::ptrdiff_t>(y), raw.data(), std::identity{});
+                for (std::size_t i = 0; i != raw.size(); ++i) {
+                    line[i] = Transfer::decode(raw[i], static_cast<std::ptrdiff_t>(i % channels) == alpha_channel);
+                }
+                middle_t* out = middle.data() + r * stride;
+                for (std::size_t x = 0; x != dw; ++x) {
+                    const work_t*   s = line.data() + hw.offset[x] * channels;
+                    const weight_t* w = hw.coeff.data() + x * hw.taps;
+                    acc_t acc[channels] = {};
+                    for (std::size_t k = 0; k != hw.taps; ++k) {
+                        for (std::size_t c = 0; c != channels; ++c) { acc[c] += static_cast<acc_t>(w[k]) * static_cast<acc_t>(s[k * channels + c]); }
+                    }
+                    for (std::size_t c = 0; c != channels; ++c) {
+                        out[x * channels + c] = detail::resample_shift<middle_t>(acc[c], detail::resample_weight_bits - middle_bits);
+                    }
+                }
+            }
+        });
+        // Vertical pass: middle -> destination, accumulate whole rows.
+        bands = force::detail::band_count(dh, detail::resample_min_pixels / dw + 1);
+        force::detail::for_each_band(dh, bands, [&](std::size_t, std::size_t beg, std::size_t end) {
+            std::vector<acc_t>   acc(stride);
+            std::vector<value_t> row(stride);
+            for (auto y = beg; y != end; ++y) {
+                std::fill(acc.begin(), acc.end(), acc_t(0));
+                const weight_t* w = vw.coeff.data() + y * vw.taps;
+                for (std::size_t k = 0; k != vw.taps; ++k) {
+                    if (w[k] == 0) continue;
+                    const middle_t* s = middle.data() + (vw.offset[y] + k - row_beg) * stride;
+                    const acc_t     f = static_cast<acc_t>(w[k]);
+                    for (std::size_t i = 0; i != stride; ++i) { acc[i] += f * static_cast<acc_t>(s[i]); }
+                }
+                // The only narrowing (and clamping) of the whole pipeline.
+                for (std::size_t i = 0; i != stride; ++i) {
+                    row[i] = Transfer::template encode<value_t>(detail::resample_shift<work_t>(acc[i], detail::resample_weight_bits + middle_bits),
+                                                                static_cast<std::ptrdiff_t>(i % channels) == alpha_channel);
+                }
+                detail::write_channel_row(dest, static_cast<std::ptrdiff_t>(y), row.data(), std::identity{});
+            }
+        });
+    }
+}
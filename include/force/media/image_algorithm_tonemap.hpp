@@ -0,0 +1,92 @@
+///
+/// \file      image_algorithm_tonemap.hpp
+/// \brief     Tone mapping operators that turn HDR (floating point) views into 8bit sRGB views.
+/// \details
+///
+/// Every operator is a per-channel curve taking linear scene value and returning linear display value
+/// in [0, 1]. tonemap_view applies exposure, the curve and sRGB encoding in one pass so no intermediate
+/// float image is written.
+///
+/// \author    HenryDu
+/// \date      18.10.2026
+/// \copyright © HenryDu 2026. All right reserved.
+///
+#pragma once
+
+#include "force/media/image_algorithm_gamma.hpp"
+
+namespace force::media {
+    /// \brief Extended Reinhard, x * (1 + x / white^2) / (1 + x), white is the smallest value mapped to 1.
+    struct reinhard_tonemap {
+        float32_t white = 4.F;
+        constexpr float32_t operator()(const float32_t x) const {
+            return x * (1.F + x * (1.F / (white * white))) / (1.F + x);
+        }
+    };
+    /// \brief Krzysztof Narkowicz's rational fit of the ACES filmic curve.
+    struct aces_fit_tonemap {
+        constexpr float32_t operator()(const float32_t x) const {
+            return (x * (2.51F * x + 0.03F)) / (x * (2.43F * x + 0.59F) + 0.14F);
+        }
+    };
+    /// \brief John Hable's (Uncharted 2) filmic curve, normalized so that white maps to 1.
+    struct filmic_tonemap {
+        float32_t shoulder_strength = 0.15F;
+        float32_t linear_strength   = 0.50F;
+        float32_t linear_angle      = 0.10F;
+        float32_t toe_strength      = 0.20F;
+        float32_t toe_numerator     = 0.02F;
+        float32_t toe_denominator   = 0.30F;
+        float32_t white             = 11.2F;
+
+        constexpr float32_t curve(const float32_t x) const {
+            const auto a = shoulder_strength, b = linear_strength, c = linear_angle;
+            const auto d = toe_strength, e = toe_numerator, f = toe_denominator;
+            return ((x * (a * x + c * b) + d * e) / (x * (a * x + b) + d * f)) - e / f;
+        }
+        constexpr float32_t operator()(const float32_t x) const {
+            // Hable's reference applies an exposure bias of 2 before the curve.
+            return curve(2.F * x) / curve(white);
+        }
+    };
+
+    /// \brief  Tone map a floating point view into an 8bit sRGB view.
+    /// \tparam SrcPix        - Pixel with floating point value_type (rgb_f32, rgb_f16, rgbe ...).
+    /// \tparam DstPix        - 8bit pixel with the same channel count.
+    /// \param  op            - Tone mapping curve, any callable float32_t -> float32_t.
+    /// \param  exposure      - Linear scale applied before the curve.
+    /// \param  alpha_channel - Channel index of alpha, that channel is only scaled to [0, 255]. Negative if there is none.
+    /// \example
+    /// tonemap_view(hdr_view, bgr_view, aces_fit_tonemap{}, 1.5F);
+    template <interleaved_pixel_concept SrcPix, interleaved_pixel_concept DstPix, typename Op>
+        requires std::is_floating_point_v<typename SrcPix::value_type> && std::is_same_v<typename DstPix::value_type, std::uint8_t>
+    void tonemap_view(const matrix_view<SrcPix> src, matrix_view<DstPix> dest, Op op, const float32_t exposure = 1.F, const std::ptrdiff_t alpha_channel = -1) {
+        using src_value_t = typename SrcPix::value_type;
+        static_assert(detail::pixel_channels_v<SrcPix> == detail::pixel_channels_v<DstPix>, "Channel count mismatch!");
+        constexpr auto channels = detail::pixel_channels_v<SrcPix>;
+
+        auto map = [&op, exposure](const float32_t v) {
+            return linear_to_srgb(op(static_cast<float32_t>(v) * exposure));
+        };
+        auto map_alpha = [](const float32_t v) {
+            return static_cast<std::uint8_t>(clamp(v, 0.F, 1.F) * 255.F + 0.5F);
+        };
+        for (std::size_t y = 0; y != src.height(); ++y) {
+            if (alpha_channel < 0 && detail::is_same_flat_layout(src, dest)) {
+                const src_value_t* s = detail::flat_row_data(src, y);
+                std::uint8_t*      d = detail::flat_row_data(dest, y);
+                for (std::size_t i = 0; i != src.width() * channels; ++i) { d[i] = map(static_cast<float32_t>(s[i])); }
+                continue;
+            }
+            auto sr = src.row_at(y);
+            auto dr = dest.row_at(y);
+            for (std::size_t x = 0; x != src.width(); ++x) {
+                const SrcPix& p = sr[x];
+                for (std::size_t c = 0; c != channels; ++c) {
+                    auto v = static_cast<float32_t>(p[c]);
+                    dr[x][c] = static_cast<std::ptrdiff_t>(c) == alpha_channel ? map_alpha(v) : map(v);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,290 @@
+///
+/// \file      image_algorithm_warp.hpp
+/// \brief     Affine and perspective warps with nearest and bilinear sampling.
+/// \details
+///
+/// The transform maps source coordinates to destination coordinates. Pixel centres sit on whole
+/// numbers. It is inverted once, and then every destination pixel looks up where it comes from.
+/// Destination pixels whose source lies outside the image get the fill value. Bilinear samples
+/// that straddle the edge blend in the fill value for their missing taps.
+///
+/// Nothing is computed per pixel that a row can compute once:
+///
+/// - Affine source coordinates are 32.32 fixed point and step by a constant along a destination
+///   row. That is one integer add per axis per pixel, and it is exact, so the coordinates don't drift.
+/// - Perspective steps the homogeneous coordinates in the same way and pays one divide per pixel.
+/// - Along a row, the set of pixels whose taps are all inside the source is one span. It is found by
+///   solving linear inequalities, and inside it coordinates, offsets and weights are computed in
+///   runs and the gathers take no bounds tests. Only the pixels before and after the span go
+///   through the checked path.
+///
+/// 8bit pixels blend with 8 bit integer weights, other pixels blend in float. Rows run in bands on
+/// the shared thread pool.
+///
+/// \author    HenryDu
+/// \date      18.10.2026
+/// \copyright © HenryDu 2026. All right reserved.
+///
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include "force/execution.hpp"
+#include "force/matrix.hpp"
+#include "force/media/image_view.hpp"
+
+namespace force::media {
+    enum class warp_filter {
+        nearest,   // Closest source pixel.
+        bilinear   // Weighted 2x2 neighbourhood.
+    };
+
+    namespace detail {
+        constexpr std::size_t  warp_min_pixels   = 1 << 14;
+        // Pixels whose coordinates and weights are computed before their gathers run.
+        constexpr std::size_t  warp_run          = 64;
+        constexpr std::int32_t warp_coord_bits   = 32;
+        constexpr std::int32_t warp_weight_bits  = 8;
+        constexpr float64_t    warp_coord_one    = 4294967296.0;
+        constexpr float64_t    warp_coord_limit  = 1073741824.0;
+
+        // Row major 3x3 map from destination pixels to homogeneous source coordinates.
+        struct warp_transform {
+            std::array<float64_t, 9> m;
+            bool                     affine;
+        };
+        // Inverse of the source -> destination map f (row major 3x3), through the adjugate.
+        inline warp_transform invert_warp(const std::array<float64_t, 9>& f, const bool affine) {
+            const auto a = f[4] * f[8] - f[5] * f[7];
+            const auto b = f[5] * f[6] - f[3] * f[8];
+            const auto c = f[3] * f[7] - f[4] * f[6];
+            const auto det = f[0] * a + f[1] * b + f[2] * c;
+            if (!(std::abs(det) > 1e-12)) {
+                throw std::runtime_error("Warp transform is not invertible!");
+            }
+            const auto k = 1.0 / det;
+            warp_transform t{ {
+                a * k, (f[2] * f[7] - f[1] * f[8]) * k, (f[1] * f[5] - f[2] * f[4]) * k,
+                b * k, (f[0] * f[8] - f[2] * f[6]) * k, (f[2] * f[3] - f[0] * f[5]) * k,
+                c * k, (f[1] * f[6] - f[0] * f[7]) * k, (f[0] * f[4] - f[1] * f[3]) * k,
+            }, affine };
+            if (affine) { t.m[6] = 0.0; t.m[7] = 0.0; t.m[8] = 1.0; }
+            return t;
+        }
+
+        inline std::int64_t warp_fixed(float64_t v) {
+            v = clamp(v, -warp_coord_limit, warp_coord_limit);
+            return static_cast<std::int64_t>(std::floor(v * warp_coord_one + 0.5));
+        }
+
+        // Source coordinates of the pixels of one destination row, k-th pixel is at (x(k), y(k)) in 32.32 fixed point.
+        struct warp_row {
+            // Homogeneous coordinates of pixel 0 and their step per pixel.
+            float64_t    nx, ny, nw, dx, dy, dw;
+            // Affine only: fixed point coordinates of pixel 0 and their step.
+            std::int64_t fx, fy, fdx, fdy;
+            bool         affine;
+
+            warp_row(const warp_transform& t, const std::ptrdiff_t y, const float64_t bias)
+                : nx(t.m[1] * y + t.m[2]), ny(t.m[4] * y + t.m[5]), nw(t.m[7] * y + t.m[8]), dx(t.m[0]), dy(t.m[3]), dw(t.m[6]), affine(t.affine) {
+                // Nearest rounds by flooring coordinates biased by half a pixel.
+                nx += bias * nw; ny += bias * nw; dx += bias * dw; dy += bias * dw;
+                fx = warp_fixed(nx); fy = warp_fixed(ny); fdx = warp_fixed(dx); fdy = warp_fixed(dy);
+            }
+            void at(const std::ptrdiff_t k, std::int64_t& x, std::int64_t& y) const {
+                if (affine) { x = fx + k * fdx; y = fy + k * fdy; return; }
+                const auto w = nw + k * dw;
+                if (w <= 0.0) { x = y = warp_fixed(-warp_coord_limit); return; }
+                x = warp_fixed((nx + k * dx) / w);
+                y = warp_fixed((ny + k * dy) / w);
+            }
+            /// \brief Pixels [beg, end) whose coordinates floor into [0, mx] x [0, my], solved on the real
+            ///        coordinates and then checked against the fixed point ones at both ends.
+            std::pair<std::ptrdiff_t, std::ptrdiff_t> span(const std::ptrdiff_t width, const std::ptrdiff_t mx, const std::ptrdiff_t my) const {
+                float64_t lo = 0.0, hi = static_cast<float64_t>(width - 1);
+                // alpha * k + beta >= 0 for every constraint.
+                auto limit = [&lo, &hi](const float64_t alpha, const float64_t beta) {
+                    if (alpha == 0.0) { if (beta < 0.0) { lo = 1.0; hi = 0.0; } return; }
+                    const auto k = -beta / alpha;
+                    if (alpha > 0.0) { lo = std::max(lo, k); }
+                    else             { hi = std::min(hi, k); }
+                };
+                constexpr float64_t margin = 1.0 / 1024.0;
+                limit(dw, nw - 1e-9);
+                limit(dx - margin * dw, nx - margin * nw);
+                limit(dy - margin * dw, ny - margin * nw);
+                limit((mx + 1 - margin) * dw - dx, (mx + 1 - margin) * nw - nx);
+                limit((my + 1 - margin) * dw - dy, (my + 1 - margin) * nw - ny);
+                if (!(lo <= hi)) return { 0, 0 };
+                auto beg = static_cast<std::ptrdiff_t>(std::ceil(lo));
+                auto end = static_cast<std::ptrdiff_t>(std::floor(hi)) + 1;
+                auto inside = [&](std::ptrdiff_t k) {
+                    std::int64_t x, y;
+                    at(k, x, y);
+                    return (x >> warp_coord_bits) >= 0 && (x >> warp_coord_bits) <= mx && (y >> warp_coord_bits) >= 0 && (y >> warp_coord_bits) <= my;
+                };
+                while (beg < end && !inside(beg))     { ++beg; }
+                while (beg < end && !inside(end - 1)) { --end; }
+                return { beg, end };
+            }
+        };
+
+        template <typename Ty>
+        constexpr Ty warp_narrow(const float32_t v) {
+            if constexpr (std::is_floating_point_v<Ty>) { return static_cast<Ty>(v); }
+            else                                        { return static_cast<Ty>(std::lround(v)); }
+        }
+        // Bilinear blend of p00 p01 (top) and p10 p11 (bottom) at fixed point fractions fx, fy.
+        template <typename Ty>
+        constexpr Ty warp_blend(const Ty p00, const Ty p01, const Ty p10, const Ty p11, const std::int64_t x, const std::int64_t y) {
+            if constexpr (std::is_integral_v<Ty> && sizeof(Ty) == 1) {
+                constexpr std::int32_t one = 1 << warp_weight_bits;
+                // Fractions rounded to [0, one], a weight of one on the far tap is still exact.
+                auto weight = [](const std::int64_t v) {
+                    return static_cast<std::int32_t>((((v & 0xFFFFFFFFll) >> (warp_coord_bits - warp_weight_bits - 1)) + 1) >> 1);
+                };
+                const auto wx = weight(x), wy = weight(y);
+                const auto top    = p00 * (one - wx) + p01 * wx;
+                const auto bottom = p10 * (one - wx) + p11 * wx;
+                return static_cast<Ty>((top * (one - wy) + bottom * wy + (1 << (2 * warp_weight_bits - 1))) >> (2 * warp_weight_bits));
+            }
+            else {
+                constexpr auto scale = static_cast<float32_t>(1.0 / warp_coord_one);
+                const auto wx = static_cast<float32_t>(x & 0xFFFFFFFFll) * scale;
+                const auto wy = static_cast<float32_t>(y & 0xFFFFFFFFll) * scale;
+                const auto top    = static_cast<float32_t>(p00) + (static_cast<float32_t>(p01) - static_cast<float32_t>(p00)) * wx;
+                const auto bottom = static_cast<float32_t>(p10) + (static_cast<float32_t>(p11) - static_cast<float32_t>(p10)) * wx;
+                return warp_narrow<Ty>(top + (bottom - top) * wy);
+            }
+        }
+
+        // Source pixels as value arrays: pixel (x, y) channel c is base[y * stride + x * channels + slot[c]].
+        template <typename Ty, std::size_t Channels>
+        struct warp_source {
+            const Ty*                         base;
+            std::ptrdiff_t                    stride;
+            std::ptrdiff_t                    width, height;
+            std::array<std::size_t, Channels> slot;
+        };
+
+        template <typename SrcPix, typename DstPix>
+        void warp_view_impl(const matrix_view<SrcPix> src, matrix_view<DstPix> dest, const warp_transform& t, const warp_filter filter, const DstPix& fill) {
+            using value_t = typename SrcPix::value_type;
+            constexpr auto channels = pixel_channels_v<SrcPix>;
+            static_assert(channels == pixel_channels_v<DstPix>, "Channel count mismatch!");
+            if (dest.width() == 0 || dest.height() == 0) return;
+
+            std::array<value_t, channels> fill_value;
+            for (std::size_t c = 0; c != channels; ++c) { fill_value[c] = static_cast<value_t>(fill[c]); }
+            const auto sw = static_cast<std::ptrdiff_t>(src.width()), sh = static_cast<std::ptrdiff_t>(src.height());
+            const auto dw = static_cast<std::ptrdiff_t>(dest.width());
+
+            // Flat sources are read in place, anything else is first packed into channel arrays.
+            std::vector<value_t>           packed;
+            warp_source<value_t, channels> s{ nullptr, sw * static_cast<std::ptrdiff_t>(channels), sw, sh, flat_channel_slots_v<SrcPix> };
+            if (sw != 0 && sh != 0) {
+                if (is_flat_view(src)) {
+                    s.base   = flat_row_data(src, 0);
+                    s.stride = src.row_delta() * static_cast<std::ptrdiff_t>(channels);
+                }
+                else {
+                    packed.resize(src.width() * src.height() * channels);
+                    for (std::ptrdiff_t y = 0; y != sh; ++y) { read_channel_row(src, y, packed.data() + y * s.stride, std::identity{}); }
+                    s.base = packed.data();
+                    for (std::size_t c = 0; c != channels; ++c) { s.slot[c] = c; }
+                }
+            }
+            const bool bilinear = filter == warp_filter::bilinear;
+            // Largest whole source coordinate whose taps are all inside.
+            const auto mx = bilinear ? sw - 2 : sw - 1, my = bilinear ? sh - 2 : sh - 1;
+            auto tap = [&s, &fill_value](std::int64_t x, std::int64_t y, std::size_t c) {
+                return (x >= 0 && x < s.width && y >= 0 && y < s.height) ? s.base[y * s.stride + x * channels + s.slot[c]] : fill_value[c];
+            };
+
+            auto bands = force::detail::band_count(dest.height(), warp_min_pixels / dest.width() + 1);
+            force::detail::for_each_band(dest.height(), bands, [&](std::size_t, std::size_t beg, std::size_t end) {
+                std::vector<value_t>        line(dest.width() * channels);
+                std::vector<std::ptrdiff_t> offset(warp_run);
+                std::vector<std::int64_t>   cx(warp_run), cy(warp_run);
+                for (auto y = beg; y != end; ++y) {
+                    const warp_row row(t, static_cast<std::ptrdiff_t>(y), bilinear ? 0.0 : 0.5);
+                    const auto [kb, ke] = (mx < 0 || my < 0) ? std::pair<std::ptrdiff_t, std::ptrdiff_t>{ 0, 0 } : row.span(dw, mx, my);
+                    // Checked path, taps outside the source read the fill value.
+                    auto checked = [&](std::ptrdiff_t k0, std::ptrdiff_t k1) {
+                        for (auto k = k0; k < k1; ++k) {
+                            std::int64_t sx, sy;
+                            row.at(k, sx, sy);
+                            const auto ix = sx >> warp_coord_bits, iy = sy >> warp_coord_bits;
+                            value_t* d = line.data() + k * channels;
+                            for (std::size_t c = 0; c != channels; ++c) {
+                                d[c] = bilinear ? warp_blend(tap(ix, iy, c), tap(ix + 1, iy, c), tap(ix, iy + 1, c), tap(ix + 1, iy + 1, c), sx, sy)
+                                                : tap(ix, iy, c);
+                            }
+                        }
+                    };
+                    checked(0, kb);
+                    // Span, in runs: coordinates and offsets first, then the unchecked gathers.
+                    for (auto k0 = kb; k0 < ke; k0 += warp_run) {
+                        const auto n = std::min<std::ptrdiff_t>(warp_run, ke - k0);
+                        if (row.affine) {
+                            auto sx = row.fx + k0 * row.fdx, sy = row.fy + k0 * row.fdy;
+                            for (std::ptrdiff_t i = 0; i != n; ++i, sx += row.fdx, sy += row.fdy) { cx[i] = sx; cy[i] = sy; }
+                        }
+                        else {
+                            for (std::ptrdiff_t i = 0; i != n; ++i) { row.at(k0 + i, cx[i], cy[i]); }
+                        }
+                        for (std::ptrdiff_t i = 0; i != n; ++i) {
+                            offset[i] = (cy[i] >> warp_coord_bits) * s.stride + (cx[i] >> warp_coord_bits) * static_cast<std::ptrdiff_t>(channels);
+                        }
+                        value_t* d = line.data() + k0 * channels;
+                        if (bilinear) {
+                            for (std::ptrdiff_t i = 0; i != n; ++i) {
+                                const value_t* p0 = s.base + offset[i];
+                                const value_t* p1 = p0 + s.stride;
+                                for (std::size_t c = 0; c != channels; ++c) {
+                                    const auto o = s.slot[c];
+                                    d[i * channels + c] = warp_blend(p0[o], p0[channels + o], p1[o], p1[channels + o], cx[i], cy[i]);
+                                }
+                            }
+                        }
+                        else {
+                            for (std::ptrdiff_t i = 0; i != n; ++i) {
+                                const value_t* p = s.base + offset[i];
+                                for (std::size_t c = 0; c != channels; ++c) { d[i * channels + c] = p[s.slot[c]]; }
+                            }
+                        }
+                    }
+                    checked(std::max(kb, ke), dw);
+                    write_channel_row(dest, static_cast<std::ptrdiff_t>(y), line.data(), std::identity{});
+                }
+            });
+        }
+    }
+
+    /// \brief  Affine warp: dest(m * (x, y, 1)) = src(x, y).
+    /// \param  m    - 2x3 map from source to destination coordinates, e.g. rotation and skew in the left 2x2, translation on the right.
+    /// \param  fill - Value of destination pixels that map outside the source.
+    /// \example
+    /// // Rotate by 30 degrees around the centre (cx, cy).
+    /// const float c = std::cos(a), s = std::sin(a);
+    /// warp_affine_view(src, dest, matrix<float32_t, 2, 3>(c, -s, cx - c * cx + s * cy, s, c, cy - s * cx - c * cy));
+    template <interleaved_pixel_concept SrcPix, interleaved_pixel_concept DstPix>
+        requires std::is_same_v<typename SrcPix::value_type, typename DstPix::value_type>
+    void warp_affine_view(const matrix_view<SrcPix> src, matrix_view<DstPix> dest, const matrix<float32_t, 2, 3>& m,
+                          const warp_filter filter = warp_filter::bilinear, const DstPix fill = DstPix{}) {
+        const auto t = detail::invert_warp({ m[0], m[1], m[2], m[3], m[4], m[5], 0.0, 0.0, 1.0 }, true);
+        detail::warp_view_impl(src, dest, t, filter, fill);
+    }
+    /// \brief  Perspective warp (homography): dest(m * (x, y, 1)) = src(x, y), divided by the third coordinate.
+    template <interleaved_pixel_concept SrcPix, interleaved_pixel_concept DstPix>
+        requires std::is_same_v<typename SrcPix::value_type, typename DstPix::value_type>
+    void warp_perspective_view(const matrix_view<SrcPix> src, matrix_view<DstPix> dest, const matrix<float32_t, 3, 3>& m,
+                               const warp_filter filter = warp_filter::bilinear, const DstPix fill = DstPix{}) {
+        const auto t = detail::invert_warp({ m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8] }, false);
+        detail::warp_view_impl(src, dest, t, filter, fill);
+    }
+}
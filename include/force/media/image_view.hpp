@@ -8,15 +8,125 @@
 ///
 #pragma once
 
+#include <array>
 #include <utility>
 #include <variant>
 
 #include "force/matrix_view.hpp"
 #include "force/media/pixels.hpp"
+#include "force/media/utility.hpp"
 namespace force::media {
     template <interleaved_pixel_concept Pix>
     using image_interleaved_view = matrix_view<Pix>;
 
+    namespace detail {
+        // Channel count of a pixel type without needing an instance.
+        template <interleaved_pixel_concept Pix>
+        constexpr std::size_t pixel_channels_v = Pix{}.size();
+        // Flat pixel is a pixel that is nothing more than an array of its channels, so a contiguous row
+        // of them can be walked as one plain value_type array (this is what lets loops vectorize).
+        template <typename Pix>
+        concept flat_pixel_concept = homogeneous_interleaved_pixel_concept<Pix> &&
+                                     (sizeof(Pix) == pixel_channels_v<Pix> * sizeof(typename Pix::value_type));
+
+        template <typename Pix>
+        constexpr bool is_flat_view(const matrix_view<Pix>& view) {
+            if constexpr (flat_pixel_concept<Pix>) { return view.col_delta() == 1; }
+            else                                   { return false; }
+        }
+        // Only valid when is_flat_view(view) is true.
+        template <typename Pix>
+        constexpr decltype(auto) flat_row_data(matrix_view<Pix> view, std::ptrdiff_t y) {
+            return reinterpret_cast<typename Pix::value_type*>(view.data() + y * view.row_delta());
+        }
+        // Memory slot of channel c (the one p[c] returns) of a flat pixel. Flat row loops read s[x * channels + slot[c]]
+        // so that they see channels in the same order as per pixel loops over strided views do. Identity for other pixels.
+        template <interleaved_pixel_concept Pix>
+        constexpr auto flat_channel_slots_v = [] {
+            constexpr auto channels = pixel_channels_v<Pix>;
+            std::array<std::size_t, channels> slots{};
+            // Constructor arguments are in memory order, so p[c] of the pixel (0, 1, 2, ...) is the slot of c.
+            constexpr auto probe = []<std::size_t... I>(std::index_sequence<I...>) {
+                if constexpr (requires { Pix(static_cast<typename Pix::value_type>(I)...); }) {
+                    return Pix(static_cast<typename Pix::value_type>(I)...);
+                }
+            };
+            if constexpr (flat_pixel_concept<Pix> && !std::is_void_v<decltype(probe(std::make_index_sequence<channels>{}))>) {
+                const auto p = probe(std::make_index_sequence<channels>{});
+                for (std::size_t c = 0; c != channels; ++c) { slots[c] = static_cast<std::size_t>(p[c]); }
+            }
+            else {
+                for (std::size_t c = 0; c != channels; ++c) { slots[c] = c; }
+            }
+            return slots;
+        }();
+        template <interleaved_pixel_concept Pix>
+        constexpr bool flat_channels_in_order_v = [] {
+            for (std::size_t c = 0; c != pixel_channels_v<Pix>; ++c) { if (flat_channel_slots_v<Pix>[c] != c) return false; }
+            return true;
+        }();
+        // Whether src and dest rows can be walked together as flat arrays, s[i] -> d[i]. Both views have to be flat,
+        // and both pixels have to keep their channels in the same slots, or s[i] and d[i] would be different p[c].
+        template <interleaved_pixel_concept Src, interleaved_pixel_concept Dst>
+        constexpr bool is_same_flat_layout(const matrix_view<Src>& src, const matrix_view<Dst>& dest) {
+            if constexpr (pixel_channels_v<Src> != pixel_channels_v<Dst>) { return false; }
+            else { return flat_channel_slots_v<Src> == flat_channel_slots_v<Dst> && is_flat_view(src) && is_flat_view(dest); }
+        }
+
+        /// \brief  Read row y of view into out as width * channels values in channel order (p[0], p[1], ...),
+        ///         each one passed through f.
+        template <typename Pix, typename Out, typename Fn>
+        void read_channel_row(const matrix_view<Pix>& view, const std::ptrdiff_t y, Out* out, Fn f) {
+            constexpr auto channels = pixel_channels_v<Pix>;
+            const auto     w        = view.width();
+            if constexpr (flat_pixel_concept<Pix>) {
+                if (is_flat_view(view)) {
+                    const auto* s = flat_row_data(view, y);
+                    if constexpr (flat_channels_in_order_v<Pix>) {
+                        for (std::size_t i = 0; i != w * channels; ++i) { out[i] = f(s[i]); }
+                    }
+                    else {
+                        constexpr auto slot = flat_channel_slots_v<Pix>;
+                        for (std::size_t x = 0; x != w; ++x) {
+                            for (std::size_t c = 0; c != channels; ++c) { out[x * channels + c] = f(s[x * channels + slot[c]]); }
+                        }
+                    }
+                    return;
+                }
+            }
+            auto row = view.row_at(y);
+            for (std::size_t x = 0; x != w; ++x) {
+                const Pix& p = row[x];
+                for (std::size_t c = 0; c != channels; ++c) { out[x * channels + c] = f(static_cast<typename Pix::value_type>(p[c])); }
+            }
+        }
+        /// \brief  Write width * channels values in channel order from in to row y of view, each one passed through f.
+        template <typename Pix, typename In, typename Fn>
+        void write_channel_row(matrix_view<Pix> view, const std::ptrdiff_t y, const In* in, Fn f) {
+            constexpr auto channels = pixel_channels_v<Pix>;
+            const auto     w        = view.width();
+            if constexpr (flat_pixel_concept<Pix>) {
+                if (is_flat_view(view)) {
+                    auto* d = flat_row_data(view, y);
+                    if constexpr (flat_channels_in_order_v<Pix>) {
+                        for (std::size_t i = 0; i != w * channels; ++i) { d[i] = f(in[i]); }
+                    }
+                    else {
+                        constexpr auto slot = flat_channel_slots_v<Pix>;
+                        for (std::size_t x = 0; x != w; ++x) {
+                            for (std::size_t c = 0; c != channels; ++c) { d[x * channels + slot[c]] = f(in[x * channels + c]); }
+                        }
+                    }
+                    return;
+                }
+            }
+            auto row = view.row_at(y);
+            for (std::size_t x = 0; x != w; ++x) {
+                for (std::size_t c = 0; c != channels; ++c) { row[x][c] = f(in[x * channels + c]); }
+            }
+        }
+    }
+
     template <typename ... PlanarPix>
     class image_planar_view {
     public:
@@ -42,9 +152,9 @@ namespace force::media {
     template <interleaved_pixel_concept ... Pix>
     class image_variant_interleaved_view {
     public:
-        constexpr image_variant_interleaved_view():mViews(){}
+        constexpr image_variant_interleaved_view():mViews(), mWidth(0), mHeight(0){}
         template <interleaved_pixel_concept Ty>
-        constexpr image_variant_interleaved_view(const image_interleaved_view<Ty> view) : mViews(view) {}
+        constexpr image_variant_interleaved_view(const image_interleaved_view<Ty> view) : mViews(view), mWidth(view.width()), mHeight(view.height()) {}
         constexpr image_variant_interleaved_view(const image_variant_interleaved_view&) = default;
         constexpr image_variant_interleaved_view(image_variant_interleaved_view&&)      = default;
 
@@ -56,10 +166,39 @@ namespace force::media {
         template <interleaved_pixel_concept Ty>
         constexpr decltype(auto) get() const { return std::get<image_interleaved_view<Ty>>(mViews); }
 
+        // Dimensions are kept outside the variant so asking for them never needs a visit.
+        constexpr std::size_t width()  const { return mWidth; }
+        constexpr std::size_t height() const { return mHeight; }
+        constexpr std::size_t index()  const { return mViews.index(); }
+
+        /// \brief  Resolve the active pixel type once and call f with the typed view (as an lvalue).
+        /// \retval - What f returns, f must return the same type for every pixel type.
+        template <typename Fn>
+        constexpr decltype(auto) visit(Fn f) const { return detail::visit_view_variant(mViews, f); }
+
         ~image_variant_interleaved_view() = default;
     private:
         std::variant<image_interleaved_view<Pix>...> mViews;
+        std::size_t                                  mWidth, mHeight;
     };
+    /// \brief  Call f(row, y) for every row of a variant view, the pixel type is resolved once for the whole image
+    ///         so the loops inside f are fully typed.
+    /// \example
+    /// visit_rows(bmp.view, [](auto row, std::size_t y) {
+    ///     for (auto& p : row) { ... }
+    /// });
+    template <class VariantInterleavedView, typename Fn>
+    constexpr void visit_rows(const VariantInterleavedView& view, Fn f) {
+        view.visit([&f](auto& v) {
+            for (std::size_t y = 0; y != v.height(); ++y) { std::invoke(f, v.row_at(y), y); }
+        });
+    }
+    /// \brief  Call f(tile, x, y) for every tile_w x tile_h sub-view (smaller on the right and bottom edges),
+    ///         (x, y) is the tile's top left pixel. The pixel type is resolved once for the whole image.
+    template <class VariantInterleavedView, typename Fn>
+    constexpr void visit_tiles(const VariantInterleavedView& view, std::size_t tile_w, std::size_t tile_h, Fn f) {
+        view.visit([&f, tile_w, tile_h](auto& v) { for_each_tile(v, tile_w, tile_h, f); });
+    }
     /// \brief  
     /// \tparam VariantInterleavedView - A image_variant_interleaved alias.
     /// \param  data                   - Pointer which pointed to actual data.
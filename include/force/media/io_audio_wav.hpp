@@ -57,25 +57,10 @@ namespace force::media::io {
         }
         return wave;
     }
+    // The view already knows its sample type, depth and channel are kept in the signature for compatibility.
     template <typename Fn>
-    constexpr decltype(auto) visit_audio_wave_view(audio_wave_interleaved_view view, std::uint8_t depth, std::uint8_t channel, Fn f) {
-        switch (depth) {
-        case 8:
-            switch (channel) {
-            case 1: return std::invoke(f, view.get<mono_s8_sample>());
-            case 2: return std::invoke(f, view.get<stereo_s8_sample>());}
-            break;
-        case 16:
-            switch (channel) {
-            case 1: return std::invoke(f, view.get<mono_s16_sample>());
-            case 2: return std::invoke(f, view.get<stereo_s16_sample>()); }
-            break;
-        case 32:
-            switch (channel) {
-            case 1: return std::invoke(f, view.get<mono_f32_sample>());
-            case 2: return std::invoke(f, view.get<stereo_f32_sample>()); }
-            break;
-        }
+    constexpr decltype(auto) visit_audio_wave_view(audio_wave_interleaved_view view, std::uint8_t, std::uint8_t, Fn f) {
+        return view.visit(f);
     }
     template <typename Fn>
     constexpr decltype(auto) visit_audio_wave(audio_wave& wav, Fn f) {
@@ -90,7 +75,7 @@ namespace force::media::io {
         return audio_wave(view, sizeof(Sample::value_type) << 3, Sample::num_dimensions, frequency);
     }
     inline std::size_t audio_wave_byte_size(const audio_wave& wav) {
-        return visit_audio_wave(wav, [](auto& v) { return v.size(); }) * wav.channel * wav.depth >> 3;
+        return wav.view.size() * wav.channel * wav.depth >> 3;
     }
     // Filestream I/O.
 
@@ -54,21 +54,17 @@ namespace force::media::io {
                 bmp.padding = (w & 1) == 0 ? 0 : 2; break;
         case 3: bmp.view = make_image_variant_interleaved_view<image_bmp_interleaved_view>(reinterpret_cast<bgr888_u8_pixel_t*>(ptr), w, h, w);
                 bmp.padding = w & 3; break;
-        case 4: bmp.view = make_image_variant_interleaved_view<image_bmp_interleaved_view>(reinterpret_cast<bgr888_u8_pixel_t*>(ptr), w, h, w);
+        case 4: bmp.view = make_image_variant_interleaved_view<image_bmp_interleaved_view>(reinterpret_cast<bgra8888_u8_pixel_t*>(ptr), w, h, w);
                 bmp.padding = 0; break;
         default:bmp.padding = -1; break;
         }
         return bmp;
     }
     // f takes in the active view.
+    // The view already knows its pixel type, depth is kept in the signature for compatibility.
     template <typename Fn>
-    constexpr decltype(auto) visit_image_bmp_interleaved_view(image_bmp_interleaved_view view, std::uint8_t depth, Fn f) {
-        switch (depth >> 3) {
-        case 1: return std::invoke(f, view.get<grey_u8_pixel_t>());
-        case 2: return std::invoke(f, view.get<bgr565_u16_pixel_t>());
-        case 3: return std::invoke(f, view.get<bgr888_u8_pixel_t>());
-        case 4: return std::invoke(f, view.get<bgra8888_u8_pixel_t>());
-        }
+    constexpr decltype(auto) visit_image_bmp_interleaved_view(image_bmp_interleaved_view view, std::uint8_t, Fn f) {
+        return view.visit(f);
     }
     template <interleaved_pixel_concept Px>
     image_bmp make_image_bmp_from_view(image_interleaved_view<Px> view) {
@@ -91,8 +87,13 @@ namespace force::media::io {
     constexpr decltype(auto) visit_image_bmp(const image_bmp& bmp, Fn f) {
         return visit_image_bmp_interleaved_view(bmp.view, bmp.depth, f);
     }
+    /// \brief Call f(row, y) on every row with the pixel type resolved once.
+    template <typename Fn>
+    constexpr void visit_image_bmp_rows(const image_bmp& bmp, Fn f) {
+        visit_rows(bmp.view, f);
+    }
     inline std::size_t image_bmp_byte_size(const image_bmp& bmp) {
-        return visit_image_bmp(bmp, [](auto& v) { return v.width(); }) * visit_image_bmp(bmp, [](auto& v) { return v.height(); }) * bmp.depth >> 3;
+        return bmp.view.width() * bmp.view.height() * bmp.depth >> 3;
     }
 
     /// \brief  A bmp reader which returns the information you need for dynamically handle bmp in memory
@@ -150,8 +151,8 @@ namespace force::media::io {
             throw std::runtime_error("Error, invalid bits-per-pixel format!");
         }
 
-        auto width  = visit_image_bmp(img, [](auto& v) { return v.width(); });
-        auto height = visit_image_bmp(img, [](auto& v) { return v.height(); });
+        auto width  = img.view.width();
+        auto height = img.view.height();
         auto channel   = img.depth >> 3;
         auto padding = img.padding;
 
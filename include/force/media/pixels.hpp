@@ -12,6 +12,8 @@
 #include <concepts>
 #include <bit>
 #include <bitset>
+#include <functional>
+#include <utility>
 
 #include "force/vector.hpp"
 
@@ -90,6 +92,8 @@ namespace force::media {
             constexpr multichannel_pixel_t() = default;
             template <typename ... Args> requires std::is_convertible_v<std::common_type_t<Args...>, value_type>
             constexpr multichannel_pixel_t(const Args ... args) : mData{ static_cast<value_type>(args)..., } {}
+            // Channels in memory order, the inverse of the vector conversion.
+            constexpr explicit multichannel_pixel_t(const vector<value_type, sizeof ...(Sequence)>& v) : mData(v) {}
             constexpr multichannel_pixel_t(const multichannel_pixel_t&) = default;
             constexpr multichannel_pixel_t(multichannel_pixel_t&&) = default;
             constexpr multichannel_pixel_t& operator=(const multichannel_pixel_t&) = default;
@@ -99,10 +103,181 @@ namespace force::media {
             constexpr reference         operator[](std::ptrdiff_t i) { return mData[sAccessor[i]]; }
             constexpr const_reference   operator[](std::ptrdiff_t i)      const { return mData[sAccessor[i]]; }
             constexpr operator vector<value_type, sizeof ...(Sequence)>() const { return mData; }
+
+            /// \brief  Pixel of f(this channel, other channels...) for every channel, with channel type To. Channels are
+            ///         walked in memory order with no temporaries, so loops over pixels can vectorize.
+            template <typename To = value_type, typename Fn, typename ... Others>
+                requires (std::is_same_v<Others, multichannel_pixel_t> && ...)
+            constexpr multichannel_pixel_t<To, Sequence...> transform(Fn f, const Others& ... others) const {
+                auto at = [&]<std::size_t I>() { return static_cast<To>(f(mData[I], others.mData[I]...)); };
+                return [&]<std::size_t ... I>(std::index_sequence<I...>) {
+                    return multichannel_pixel_t<To, Sequence...>(at.template operator()<I>()...);
+                }(std::make_index_sequence<sizeof ...(Sequence)>{});
+            }
         private:
             static constexpr std::array<std::size_t, sizeof ...(Sequence)> sAccessor{ Sequence... };
             vector<value_type, sizeof ...(Sequence)> mData;
         };
+
+        // IEEE 754 binary16 <-> binary32, rounding to nearest even.
+        constexpr std::uint16_t float_to_half(const float32_t f) {
+            auto x    = std::bit_cast<std::uint32_t>(f);
+            auto sign = static_cast<std::uint16_t>((x >> 16) & 0x8000U);
+            auto absx = x & 0x7FFF'FFFFU;
+            if (absx >= 0x7F80'0000U) { return sign | (absx > 0x7F80'0000U ? 0x7E00U : 0x7C00U); } // NaN and infinity.
+            if (absx >= 0x4780'0000U) { return sign | 0x7C00U; }                                   // Overflow.
+            if (absx <  0x3880'0000U) {                                                            // Subnormal or zero.
+                if (absx < 0x3300'0000U) { return sign; }
+                auto e     = absx >> 23;
+                auto m     = (absx & 0x007F'FFFFU) | 0x0080'0000U;
+                auto shift = 126U - e;
+                auto h     = m >> shift;
+                auto rem   = m & ((1U << shift) - 1);
+                auto mid   = 1U << (shift - 1);
+                if (rem > mid || (rem == mid && (h & 1))) { ++h; }
+                return sign | static_cast<std::uint16_t>(h);
+            }
+            auto h   = (absx - 0x3800'0000U) >> 13;
+            auto rem = absx & 0x1FFFU;
+            if (rem > 0x1000U || (rem == 0x1000U && (h & 1))) { ++h; } // Carry into exponent is fine, even up to infinity.
+            return sign | static_cast<std::uint16_t>(h);
+        }
+        constexpr float32_t half_to_float(const std::uint16_t h) {
+            std::uint32_t sign = (h & 0x8000U) << 16;
+            std::uint32_t e    = (h >> 10) & 0x1FU;
+            std::uint32_t m    = h & 0x03FFU;
+            if (e == 0x1FU) { return std::bit_cast<float32_t>(sign | 0x7F80'0000U | (m << 13)); }
+            if (e == 0) {
+                auto f = static_cast<float32_t>(m) * (1.F / 16777216.F); // m * 2^-24
+                return sign ? -f : f;
+            }
+            return std::bit_cast<float32_t>(sign | ((e + 112U) << 23) | (m << 13));
+        }
+        // 2^e as float for normal range exponents.
+        constexpr float32_t exp2_float(const std::int32_t e) {
+            return std::bit_cast<float32_t>(static_cast<std::uint32_t>(e + 127) << 23);
+        }
+
+        // Half floats are stored as 16bit patterns, reading converts to float and writing goes through this proxy.
+        struct half_reference {
+            std::uint16_t* ptr;
+            constexpr half_reference& operator=(const float32_t value) { *ptr = float_to_half(value); return *this; }
+            constexpr operator float32_t() const { return half_to_float(*ptr); }
+        };
+        template <std::size_t ... Sequence>
+        class half_multichannel_pixel_t {
+        public:
+            using value_type = float32_t;
+
+            constexpr half_multichannel_pixel_t() = default;
+            template <typename ... Args> requires (sizeof ... (Args) == sizeof ... (Sequence)) && std::is_convertible_v<std::common_type_t<Args...>, value_type>
+            constexpr half_multichannel_pixel_t(const Args ... args) : mData{ float_to_half(static_cast<value_type>(args))..., } {}
+            constexpr half_multichannel_pixel_t(const half_multichannel_pixel_t&) = default;
+            constexpr half_multichannel_pixel_t(half_multichannel_pixel_t&&) = default;
+            constexpr half_multichannel_pixel_t& operator=(const half_multichannel_pixel_t&) = default;
+            constexpr half_multichannel_pixel_t& operator=(half_multichannel_pixel_t&&) = default;
+
+            constexpr std::size_t    size()                       const { return mData.size(); }
+            constexpr half_reference operator[](std::ptrdiff_t i)       { return half_reference{ &mData[sAccessor[i]] }; }
+            constexpr value_type     operator[](std::ptrdiff_t i) const { return half_to_float(mData[sAccessor[i]]); }
+            constexpr operator vector<value_type, sizeof ...(Sequence)>() const {
+                vector<value_type, sizeof ...(Sequence)> result;
+                for (std::size_t i = 0; i != size(); ++i) { result[i] = half_to_float(mData[i]); }
+                return result;
+            }
+        private:
+            static constexpr std::array<std::size_t, sizeof ...(Sequence)> sAccessor{ Sequence... };
+            vector<std::uint16_t, sizeof ...(Sequence)> mData;
+        };
+
+        // Shared exponent formats can't reference one channel, writing one re-encodes the whole pixel.
+        template <typename Pixel>
+        struct shared_exponent_reference {
+            Pixel*      pixel;
+            std::size_t channel;
+            constexpr shared_exponent_reference& operator=(const float32_t value) {
+                vector<float32_t, 3> c = *pixel;
+                c[channel] = value;
+                *pixel = Pixel(c[0], c[1], c[2]);
+                return *this;
+            }
+            constexpr operator float32_t() const { return static_cast<vector<float32_t, 3>>(*pixel)[channel]; }
+        };
+        // Radiance RGBE: three 8bit mantissas and one 8bit exponent shared by all of them.
+        template <std::size_t ... Sequence> requires (sizeof ... (Sequence) == 3)
+        class rgbe_packed_pixel_t {
+        public:
+            using value_type = float32_t;
+
+            constexpr rgbe_packed_pixel_t() = default;
+            constexpr rgbe_packed_pixel_t(value_type a1, value_type a2, value_type a3) : mData() {
+                auto v = a1 > a2 ? a1 : a2;
+                v = v > a3 ? v : a3;
+                if (!(v > 1e-32F)) { return; } // Also catches NaN.
+                // frexp(v) exponent, v = m * 2^e with m in [0.5, 1).
+                auto e = static_cast<std::int32_t>((std::bit_cast<std::uint32_t>(v) >> 23) & 0xFFU) - 126;
+                auto s = exp2_float(8 - e);
+                auto q = [s](value_type k) { return static_cast<std::uint8_t>(k > 0.F ? k * s : 0.F); };
+                mData = vector<std::uint8_t, 4>(q(a1), q(a2), q(a3), static_cast<std::uint8_t>(e + 128));
+            }
+            constexpr rgbe_packed_pixel_t(const rgbe_packed_pixel_t&) = default;
+            constexpr rgbe_packed_pixel_t(rgbe_packed_pixel_t&&) = default;
+            constexpr rgbe_packed_pixel_t& operator=(const rgbe_packed_pixel_t&) = default;
+            constexpr rgbe_packed_pixel_t& operator=(rgbe_packed_pixel_t&&) = default;
+
+            constexpr std::size_t size() const { return 3; }
+            constexpr decltype(auto) operator[](std::ptrdiff_t i)       { return shared_exponent_reference<rgbe_packed_pixel_t>{ this, sAccessor[i] }; }
+            constexpr value_type     operator[](std::ptrdiff_t i) const { return static_cast<vector<value_type, 3>>(*this)[sAccessor[i]]; }
+            constexpr operator vector<value_type, 3>() const {
+                if (mData[3] == 0) { return vector<value_type, 3>(0.F, 0.F, 0.F); }
+                auto f = exp2_float(static_cast<std::int32_t>(mData[3]) - (128 + 8));
+                return vector<value_type, 3>((mData[0] + 0.5F) * f, (mData[1] + 0.5F) * f, (mData[2] + 0.5F) * f);
+            }
+        private:
+            static constexpr std::array<std::size_t, 3> sAccessor = { Sequence... };
+            vector<std::uint8_t, 4> mData;
+        };
+        // Packed 32bit: three 9bit mantissas (bit 0, 9, 18) and a 5bit exponent (bit 27), as EXT_texture_shared_exponent.
+        template <std::size_t ... Sequence> requires (sizeof ... (Sequence) == 3)
+        class alignas(std::uint32_t) rgb9e5_packed_pixel_t {
+        public:
+            using value_type = float32_t;
+
+            static constexpr std::int32_t mantissa_bits = 9;
+            static constexpr std::int32_t exponent_bias = 15;
+            static constexpr value_type   max_value     = 65408.F; // (2^9 - 1) / 2^9 * 2^16
+
+            constexpr rgb9e5_packed_pixel_t() = default;
+            constexpr rgb9e5_packed_pixel_t(value_type a1, value_type a2, value_type a3) {
+                auto c = [](value_type k) { return k > 0.F ? (k < max_value ? k : max_value) : 0.F; };
+                a1 = c(a1); a2 = c(a2); a3 = c(a3);
+                auto v = a1 > a2 ? a1 : a2;
+                v = v > a3 ? v : a3;
+                // floor(log2(v)) clamped to -bias - 1.
+                auto l = static_cast<std::int32_t>((std::bit_cast<std::uint32_t>(v) >> 23) & 0xFFU) - 127;
+                auto e = (l < -exponent_bias - 1 ? -exponent_bias - 1 : l) + 1 + exponent_bias;
+                auto d = exp2_float(e - exponent_bias - mantissa_bits);
+                if (static_cast<std::uint32_t>(v / d + 0.5F) == (1U << mantissa_bits)) { d *= 2.F; ++e; }
+                auto q = [d](value_type k) { return static_cast<std::uint32_t>(k / d + 0.5F); };
+                mData = q(a1) | (q(a2) << 9) | (q(a3) << 18) | (static_cast<std::uint32_t>(e) << 27);
+            }
+            constexpr rgb9e5_packed_pixel_t(const rgb9e5_packed_pixel_t&) = default;
+            constexpr rgb9e5_packed_pixel_t(rgb9e5_packed_pixel_t&&) = default;
+            constexpr rgb9e5_packed_pixel_t& operator=(const rgb9e5_packed_pixel_t&) = default;
+            constexpr rgb9e5_packed_pixel_t& operator=(rgb9e5_packed_pixel_t&&) = default;
+
+            constexpr std::size_t size() const { return 3; }
+            constexpr decltype(auto) operator[](std::ptrdiff_t i)       { return shared_exponent_reference<rgb9e5_packed_pixel_t>{ this, sAccessor[i] }; }
+            constexpr value_type     operator[](std::ptrdiff_t i) const { return static_cast<vector<value_type, 3>>(*this)[sAccessor[i]]; }
+            constexpr operator vector<value_type, 3>() const {
+                auto f = exp2_float(static_cast<std::int32_t>(mData >> 27) - exponent_bias - mantissa_bits);
+                return vector<value_type, 3>((mData & 0x1FFU) * f, ((mData >> 9) & 0x1FFU) * f, ((mData >> 18) & 0x1FFU) * f);
+            }
+            constexpr operator std::uint32_t() const { return mData; }
+        private:
+            static constexpr std::array<std::size_t, 3> sAccessor = { Sequence... };
+            std::uint32_t mData;
+        };
     }
 
     using grey_u8_pixel_t     = detail::multichannel_pixel_t<std::uint8_t, 0>;
@@ -117,4 +292,50 @@ namespace force::media {
     // RGBA(ABGR) and ARGB(BGRA) shouldn't be placed in a single image format.
     using argb8888_u8_pixel_t = detail::multichannel_pixel_t<std::uint8_t, 3, 2, 1, 0>;
     using bgra8888_u8_pixel_t = detail::multichannel_pixel_t<std::uint8_t, 0, 1, 2, 3>;
+    // Floating point (HDR) formats, these follow the channel order convention of the 8bit ones.
+    using rgb_f32_pixel_t     = detail::multichannel_pixel_t<float32_t, 2, 1, 0>;
+    using bgr_f32_pixel_t     = detail::multichannel_pixel_t<float32_t, 0, 1, 2>;
+    using rgba_f32_pixel_t    = detail::multichannel_pixel_t<float32_t, 3, 2, 1, 0>;
+    using rgb_f16_pixel_t     = detail::half_multichannel_pixel_t<2, 1, 0>;
+    using rgba_f16_pixel_t    = detail::half_multichannel_pixel_t<3, 2, 1, 0>;
+    using rgbe_pixel_t        = detail::rgbe_packed_pixel_t<2, 1, 0>;
+    using rgb9e5_pixel_t      = detail::rgb9e5_packed_pixel_t<2, 1, 0>;
+
+    // Saturating channel arithmetic for 8 and 16bit pixels, the lane operations of vector.hpp applied channel by channel.
+    using force::saturate_cast;
+    using force::widen;
+    using force::adds;
+    using force::subs;
+    using force::avg;
+    using force::mulhi;
+    using force::absdiff;
+
+    template <std::integral To, force::detail::small_integral Ty, std::size_t ... Sequence>
+    constexpr detail::multichannel_pixel_t<To, Sequence...> saturate_cast(const detail::multichannel_pixel_t<Ty, Sequence...>& p) {
+        return p.template transform<To>([](const Ty v) { return saturate_cast<To>(v); });
+    }
+    template <force::detail::small_integral Ty, std::size_t ... Sequence>
+    constexpr decltype(auto) widen(const detail::multichannel_pixel_t<Ty, Sequence...>& p) {
+        return p.template transform<force::detail::widened_t<Ty>>(std::identity{});
+    }
+    template <force::detail::small_integral Ty, std::size_t ... Sequence>
+    constexpr decltype(auto) adds(const detail::multichannel_pixel_t<Ty, Sequence...>& a, const detail::multichannel_pixel_t<Ty, Sequence...>& b) {
+        return a.transform([](const Ty x, const Ty y) { return adds(x, y); }, b);
+    }
+    template <force::detail::small_integral Ty, std::size_t ... Sequence>
+    constexpr decltype(auto) subs(const detail::multichannel_pixel_t<Ty, Sequence...>& a, const detail::multichannel_pixel_t<Ty, Sequence...>& b) {
+        return a.transform([](const Ty x, const Ty y) { return subs(x, y); }, b);
+    }
+    template <force::detail::small_integral Ty, std::size_t ... Sequence>
+    constexpr decltype(auto) avg(const detail::multichannel_pixel_t<Ty, Sequence...>& a, const detail::multichannel_pixel_t<Ty, Sequence...>& b) {
+        return a.transform([](const Ty x, const Ty y) { return avg(x, y); }, b);
+    }
+    template <force::detail::small_integral Ty, std::size_t ... Sequence>
+    constexpr decltype(auto) mulhi(const detail::multichannel_pixel_t<Ty, Sequence...>& a, const detail::multichannel_pixel_t<Ty, Sequence...>& b) {
+        return a.transform([](const Ty x, const Ty y) { return mulhi(x, y); }, b);
+    }
+    template <force::detail::small_integral Ty, std::size_t ... Sequence>
+    constexpr decltype(auto) absdiff(const detail::multichannel_pixel_t<Ty, Sequence...>& a, const detail::multichannel_pixel_t<Ty, Sequence...>& b) {
+        return a.template transform<std::make_unsigned_t<Ty>>([](const Ty x, const Ty y) { return absdiff(x, y); }, b);
+    }
 }
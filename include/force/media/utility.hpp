@@ -10,6 +10,28 @@
 
 #include <concepts>
 #include <bit>
+#include <functional>
+#include <utility>
+#include <variant>
+
+namespace force::media::detail {
+    /// \brief Dispatch table for variants of views, built once per (variant, callable) pair at compile time.
+    ///        Unlike switching on a format tag and calling std::get (which checks the index again), this is a
+    ///        single indirect call on index() and hands f an lvalue copy of the active view.
+    template <typename Variant, typename Fn, std::size_t ... I>
+    constexpr decltype(auto) visit_view_variant(const Variant& v, Fn& f, std::index_sequence<I...>) {
+        using result_t = std::invoke_result_t<Fn&, std::variant_alternative_t<0, Variant>&>;
+        using entry_t  = result_t(*)(const Variant&, Fn&);
+        static constexpr entry_t table[] = {
+            [](const Variant& v, Fn& f) -> result_t { auto view = *std::get_if<I>(&v); return std::invoke(f, view); } ...
+        };
+        return table[v.index()](v, f);
+    }
+    template <typename Variant, typename Fn>
+    constexpr decltype(auto) visit_view_variant(const Variant& v, Fn& f) {
+        return visit_view_variant(v, f, std::make_index_sequence<std::variant_size_v<Variant>>{});
+    }
+}
 
 namespace force::media::io {
 
@@ -8,9 +8,14 @@
 ///
 #pragma once
 
+#include <algorithm>
 #include <concepts>
+#include <cstdint>
 #include <iterator>
+#include <limits>
 #include <numeric>
+#include <type_traits>
+#include <utility>
 
 #include "vector.hpp"
 #include "force/vector_view.hpp"
@@ -214,4 +219,97 @@ namespace force {
         auto a2 = std::transform_reduce(a.data(), a.data() + N, Ty(0), add, square);
         return rsqrt(a2) * a;
     }
+
+    namespace detail {
+        // 8 and 16bit integers, the lane types of the saturating operations. Intermediate results fit in int.
+        template <typename Ty>
+        concept small_integral = std::integral<Ty> && !std::same_as<Ty, bool> && (sizeof(Ty) <= sizeof(std::uint16_t));
+
+        template <std::size_t Bytes, bool Signed> struct sized_integer;
+        template <> struct sized_integer<2, false> { using type = std::uint16_t; };
+        template <> struct sized_integer<2, true>  { using type = std::int16_t; };
+        template <> struct sized_integer<4, false> { using type = std::uint32_t; };
+        template <> struct sized_integer<4, true>  { using type = std::int32_t; };
+        // Integer of twice the width and the same signedness.
+        template <small_integral Ty>
+        using widened_t = typename sized_integer<sizeof(Ty) * 2, std::is_signed_v<Ty>>::type;
+    }
+
+    // Saturating integer arithmetic: results are clamped to the range of the lane type instead of wrapping around.
+    // Lanes are 8 or 16bit integers. Every operation is written as a plain min/max/widen expression that
+    // compilers turn into paddus/psubus/pavg/pmulh/packus and friends when it sits in a loop over many lanes.
+
+    /// \brief  Clamp v to the range of To.
+    template <std::integral To, std::integral From>
+    constexpr To saturate_cast(const From v) {
+        if (std::cmp_less(v, std::numeric_limits<To>::min()))    return std::numeric_limits<To>::min();
+        if (std::cmp_greater(v, std::numeric_limits<To>::max())) return std::numeric_limits<To>::max();
+        return static_cast<To>(v);
+    }
+    template <detail::small_integral Ty>
+    constexpr Ty adds(const Ty a, const Ty b) {
+        constexpr auto lo = std::numeric_limits<Ty>::min(), hi = std::numeric_limits<Ty>::max();
+        if constexpr (std::is_unsigned_v<Ty>) { return static_cast<Ty>(std::min<Ty>(a, static_cast<Ty>(hi - b)) + b); }
+        else { return static_cast<Ty>(b > 0 ? std::min<Ty>(a, static_cast<Ty>(hi - b)) + b : std::max<Ty>(a, static_cast<Ty>(lo - b)) + b); }
+    }
+    template <detail::small_integral Ty>
+    constexpr Ty subs(const Ty a, const Ty b) {
+        constexpr auto lo = std::numeric_limits<Ty>::min(), hi = std::numeric_limits<Ty>::max();
+        if constexpr (std::is_unsigned_v<Ty>) { return static_cast<Ty>(std::max<Ty>(a, b) - b); }
+        else { return static_cast<Ty>(b > 0 ? std::max<Ty>(a, static_cast<Ty>(lo + b)) - b : std::min<Ty>(a, static_cast<Ty>(hi + b)) - b); }
+    }
+    /// \brief  Mean rounded up, (a + b + 1) / 2 without overflow.
+    template <detail::small_integral Ty>
+    constexpr Ty avg(const Ty a, const Ty b) {
+        return static_cast<Ty>((static_cast<int>(a) + static_cast<int>(b) + 1) >> 1);
+    }
+    /// \brief  High half of the double width product, a * b >> bits of Ty.
+    template <detail::small_integral Ty>
+    constexpr Ty mulhi(const Ty a, const Ty b) {
+        return static_cast<Ty>((static_cast<detail::widened_t<Ty>>(a) * static_cast<detail::widened_t<Ty>>(b)) >> (8 * sizeof(Ty)));
+    }
+    /// \brief  |a - b|, unsigned so that it can't overflow.
+    template <detail::small_integral Ty>
+    constexpr std::make_unsigned_t<Ty> absdiff(const Ty a, const Ty b) {
+        return static_cast<std::make_unsigned_t<Ty>>(static_cast<std::make_unsigned_t<Ty>>(std::max(a, b)) -
+                                                      static_cast<std::make_unsigned_t<Ty>>(std::min(a, b)));
+    }
+
+    // The same lane by lane on vectors.
+    template <std::integral To, std::integral From, std::size_t N>
+    constexpr vector<To, N> saturate_cast(const vector<From, N>& v) {
+        vector<To, N> result; for (std::size_t i = 0; i < N; ++i) { result[i] = saturate_cast<To>(v[i]); }
+        return result;
+    }
+    /// \brief  Lanes converted to the integer of twice their width, the values don't change.
+    template <detail::small_integral Ty, std::size_t N>
+    constexpr vector<detail::widened_t<Ty>, N> widen(const vector<Ty, N>& v) {
+        vector<detail::widened_t<Ty>, N> result; for (std::size_t i = 0; i < N; ++i) { result[i] = v[i]; }
+        return result;
+    }
+    template <detail::small_integral Ty, std::size_t N>
+    constexpr vector<Ty, N> adds(const vector<Ty, N>& a, const vector<Ty, N>& b) {
+        vector<Ty, N> result; for (std::size_t i = 0; i < N; ++i) { result[i] = adds(a[i], b[i]); }
+        return result;
+    }
+    template <detail::small_integral Ty, std::size_t N>
+    constexpr vector<Ty, N> subs(const vector<Ty, N>& a, const vector<Ty, N>& b) {
+        vector<Ty, N> result; for (std::size_t i = 0; i < N; ++i) { result[i] = subs(a[i], b[i]); }
+        return result;
+    }
+    template <detail::small_integral Ty, std::size_t N>
+    constexpr vector<Ty, N> avg(const vector<Ty, N>& a, const vector<Ty, N>& b) {
+        vector<Ty, N> result; for (std::size_t i = 0; i < N; ++i) { result[i] = avg(a[i], b[i]); }
+        return result;
+    }
+    template <detail::small_integral Ty, std::size_t N>
+    constexpr vector<Ty, N> mulhi(const vector<Ty, N>& a, const vector<Ty, N>& b) {
+        vector<Ty, N> result; for (std::size_t i = 0; i < N; ++i) { result[i] = mulhi(a[i], b[i]); }
+        return result;
+    }
+    template <detail::small_integral Ty, std::size_t N>
+    constexpr vector<std::make_unsigned_t<Ty>, N> absdiff(const vector<Ty, N>& a, const vector<Ty, N>& b) {
+        vector<std::make_unsigned_t<Ty>, N> result; for (std::size_t i = 0; i < N; ++i) { result[i] = absdiff(a[i], b[i]); }
+        return result;
+    }
 }
\ No newline at end of file
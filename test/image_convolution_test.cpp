@@ -0,0 +1,146 @@
+#include "image_test_util.hpp"
+
+#include <cmath>
+
+#include "force/media/image_algorithm_convolution.hpp"
+
+using namespace force;
+using namespace force::media;
+using force::test::test_image;
+using force::test::reference_border;
+
+// Direct correlation with a kw x kh row major kernel anchored at its centre.
+template <typename Pix>
+test_image<rgb_f32_pixel_t> reference_convolve(const test_image<Pix>& src, const std::vector<float32_t>& kernel, const std::ptrdiff_t kw,
+                                               const std::ptrdiff_t kh, const border_policy border) {
+    const auto w = static_cast<std::ptrdiff_t>(src.width), h = static_cast<std::ptrdiff_t>(src.height);
+    test_image<rgb_f32_pixel_t> out(src.width, src.height);
+    for (std::ptrdiff_t y = 0; y != h; ++y) {
+        for (std::ptrdiff_t x = 0; x != w; ++x) {
+            for (std::size_t c = 0; c != 3; ++c) {
+                float64_t acc = 0.0;
+                for (std::ptrdiff_t j = 0; j != kh; ++j) {
+                    for (std::ptrdiff_t i = 0; i != kw; ++i) {
+                        const auto sx = reference_border(x + i - kw / 2, w, border), sy = reference_border(y + j - kh / 2, h, border);
+                        acc += kernel[j * kw + i] * static_cast<float64_t>(src.at(sx, sy)[c]);
+                    }
+                }
+                out.at(x, y)[c] = static_cast<float32_t>(acc);
+            }
+        }
+    }
+    return out;
+}
+
+template <typename Pix>
+float32_t max_difference(const test_image<Pix>& a, const test_image<rgb_f32_pixel_t>& b) {
+    float32_t d = 0.F;
+    for (std::size_t y = 0; y != a.height; ++y) {
+        for (std::size_t x = 0; x != a.width; ++x) {
+            for (std::size_t c = 0; c != 3; ++c) { d = std::max(d, std::abs(static_cast<float32_t>(a.at(x, y)[c]) - b.at(x, y)[c])); }
+        }
+    }
+    return d;
+}
+
+constexpr border_policy borders[] = { border_policy::clamp, border_policy::mirror, border_policy::wrap };
+
+// Full and separable (rank one) kernels, float and 8bit pixels, every border.
+void test_convolve() {
+    test_image<rgb_f32_pixel_t> src(67, 41, 2);
+    force::test::fill_random(src, -1.F, 1.F);
+    std::vector<float32_t> full(5 * 3);
+    for (auto& k : full) { k = force::test::random_value(-1.F, 1.F); }
+    const float32_t col[3] = { 1.F, -2.F, 0.5F }, row[5] = { 0.25F, 1.F, -1.F, 2.F, 0.5F };
+    std::vector<float32_t> outer(5 * 3);
+    for (std::size_t j = 0; j != 3; ++j) {
+        for (std::size_t i = 0; i != 5; ++i) { outer[j * 5 + i] = col[j] * row[i]; }
+    }
+    for (const auto border : borders) {
+        for (auto* kernel : { &full, &outer }) {
+            test_image<rgb_f32_pixel_t> dest(src.width, src.height, 1);
+            convolve_view(src.view(), dest.view(), matrix_view<float32_t>(kernel->data(), 0, 0, 5, 3, 5), border);
+            FORCE_CHECK(max_difference(dest, reference_convolve(src, *kernel, 5, 3, border)) < 1e-4F);
+        }
+        test_image<rgb_f32_pixel_t> dest(src.width, src.height);
+        convolve_separable_view(src.view(), dest.view(), std::span<const float32_t>(row), std::span<const float32_t>(col), border);
+        FORCE_CHECK(max_difference(dest, reference_convolve(src, outer, 5, 3, border)) < 1e-4F);
+    }
+    // 8bit results are rounded and clamped.
+    test_image<rgb888_u8_pixel_t> bytes(53, 29, 3);
+    force::test::fill_random(bytes, 0, 255);
+    float32_t sharpen[9] = { 0.F, -1.F, 0.F, -1.F, 5.F, -1.F, 0.F, -1.F, 0.F };
+    test_image<rgb888_u8_pixel_t> sharp(bytes.width, bytes.height);
+    convolve_view(bytes.view(), sharp.view(), matrix_view<float32_t>(sharpen, 0, 0, 3, 3, 3));
+    auto ref = reference_convolve(bytes, std::vector<float32_t>(sharpen, sharpen + 9), 3, 3, border_policy::clamp);
+    for (auto& p : ref.pixels) {
+        for (std::size_t c = 0; c != 3; ++c) { p[c] = std::round(std::clamp(p[c], 0.F, 255.F)); }
+    }
+    FORCE_CHECK(max_difference(sharp, ref) == 0.F);
+    // In place.
+    auto copy = src;
+    convolve_view(copy.view(), copy.view(), matrix_view<float32_t>(full.data(), 0, 0, 5, 3, 5));
+    FORCE_CHECK(max_difference(copy, reference_convolve(src, full, 5, 3, border_policy::clamp)) < 1e-4F);
+}
+
+// Running sum box blur against the window mean.
+void test_box_blur() {
+    test_image<rgb_f32_pixel_t> src(77, 45, 1);
+    force::test::fill_random(src, 0.F, 1.F);
+    for (const auto border : borders) {
+        for (const auto& [rx, ry] : { std::pair<std::size_t, std::size_t>{ 3, 2 }, { 0, 5 }, { 9, 0 } }) {
+            const auto kw = static_cast<std::ptrdiff_t>(2 * rx + 1), kh = static_cast<std::ptrdiff_t>(2 * ry + 1);
+            std::vector<float32_t> kernel(kw * kh, 1.F / static_cast<float32_t>(kw * kh));
+            test_image<rgb_f32_pixel_t> dest(src.width, src.height);
+            box_blur_view(src.view(), dest.view(), rx, ry, border);
+            FORCE_CHECK(max_difference(dest, reference_convolve(src, kernel, kw, kh, border)) < 1e-4F);
+        }
+    }
+}
+
+// Sampled Gaussian for small sigma, box cascade for large sigma, identity for 0.
+void test_gaussian_blur() {
+    test_image<rgb_f32_pixel_t> src(96, 80);
+    force::test::fill_random(src, 0.F, 1.F);
+    auto gaussian = [&](const float32_t sigma) {
+        const auto r = static_cast<std::ptrdiff_t>(std::ceil(3.F * sigma));
+        std::vector<float32_t> taps(2 * r + 1);
+        float32_t sum = 0.F;
+        for (std::ptrdiff_t i = -r; i <= r; ++i) { sum += taps[i + r] = std::exp(-static_cast<float32_t>(i * i) / (2.F * sigma * sigma)); }
+        std::vector<float32_t> kernel(taps.size() * taps.size());
+        for (std::size_t j = 0; j != taps.size(); ++j) {
+            for (std::size_t i = 0; i != taps.size(); ++i) { kernel[j * taps.size() + i] = taps[j] * taps[i] / (sum * sum); }
+        }
+        return reference_convolve(src, kernel, 2 * r + 1, 2 * r + 1, border_policy::mirror);
+    };
+    test_image<rgb_f32_pixel_t> dest(src.width, src.height);
+    gaussian_blur_view(src.view(), dest.view(), 1.5F, border_policy::mirror);
+    FORCE_CHECK(max_difference(dest, gaussian(1.5F)) < 1e-4F);
+    // Three extended boxes only approximate the Gaussian.
+    gaussian_blur_view(src.view(), dest.view(), 4.F, border_policy::mirror);
+    FORCE_CHECK(max_difference(dest, gaussian(4.F)) < 0.01F);
+
+    gaussian_blur_view(src.view(), dest.view(), 0.F);
+    FORCE_CHECK(max_difference(dest, src) == 0.F);
+    FORCE_CHECK_THROWS(gaussian_blur_view(src.view(), dest.view(), -1.F));
+    FORCE_CHECK_THROWS(gaussian_blur_view(src.view(), dest.view(), NAN));
+}
+
+// dest must have the size of src.
+void test_size_mismatch() {
+    test_image<rgb_f32_pixel_t> src(16, 16), dest(32, 32);
+    float32_t taps[3] = { 0.25F, 0.5F, 0.25F };
+    FORCE_CHECK_THROWS(convolve_separable_view(src.view(), dest.view(), std::span<const float32_t>(taps), std::span<const float32_t>(taps)));
+    FORCE_CHECK_THROWS(convolve_view(src.view(), dest.view(), matrix_view<float32_t>(taps, 0, 0, 3, 1, 3)));
+    FORCE_CHECK_THROWS(box_blur_view(src.view(), dest.view(), 1, 1));
+    FORCE_CHECK_THROWS(gaussian_blur_view(src.view(), dest.view(), 1.F));
+    FORCE_CHECK_THROWS(gaussian_blur_view(dest.view(), src.view(), 0.F));
+}
+
+int main() {
+    test_convolve();
+    test_box_blur();
+    test_gaussian_blur();
+    test_size_mismatch();
+    return force::test::report("image_convolution_test");
+}
@@ -0,0 +1,127 @@
+#include "image_test_util.hpp"
+
+#include <cmath>
+#include <queue>
+
+#include "force/media/image_algorithm_distance.hpp"
+
+using namespace force;
+using namespace force::media;
+using force::test::test_image;
+
+// Random mask whose zero pixels (seeds) have the given density in per mille.
+test_image<grey_u8_pixel_t> random_mask(const std::size_t w, const std::size_t h, const int density) {
+    test_image<grey_u8_pixel_t> mask(w, h, 1);
+    for (auto& p : mask.pixels) { p[0] = force::test::random_value(0, 999) < density ? 0 : 255; }
+    return mask;
+}
+
+// Distance to every seed, the smallest one.
+std::vector<float64_t> reference_euclidean(const test_image<grey_u8_pixel_t>& mask) {
+    std::vector<std::pair<std::ptrdiff_t, std::ptrdiff_t>> seeds;
+    for (std::size_t y = 0; y != mask.height; ++y) {
+        for (std::size_t x = 0; x != mask.width; ++x) {
+            if (mask.at(x, y)[0] == 0) seeds.emplace_back(x, y);
+        }
+    }
+    std::vector<float64_t> d(mask.width * mask.height, std::numeric_limits<float64_t>::infinity());
+    for (std::size_t y = 0; y != mask.height; ++y) {
+        for (std::size_t x = 0; x != mask.width; ++x) {
+            std::int64_t best = std::numeric_limits<std::int64_t>::max();
+            for (const auto& [sx, sy] : seeds) {
+                const auto dx = static_cast<std::int64_t>(x) - sx, dy = static_cast<std::int64_t>(y) - sy;
+                best = std::min(best, dx * dx + dy * dy);
+            }
+            if (!seeds.empty()) d[y * mask.width + x] = std::sqrt(static_cast<float64_t>(best));
+        }
+    }
+    return d;
+}
+
+// Shortest paths over the chamfer moves (Dijkstra), in units of one pixel step.
+std::vector<float64_t> reference_chamfer(const test_image<grey_u8_pixel_t>& mask, const chamfer_kernel kernel) {
+    struct move { std::ptrdiff_t dx, dy; std::uint32_t cost; };
+    std::vector<move> moves;
+    const bool five = kernel == chamfer_kernel::five_seven_eleven;
+    for (std::ptrdiff_t dy = -2; dy <= 2; ++dy) {
+        for (std::ptrdiff_t dx = -2; dx <= 2; ++dx) {
+            const auto ax = std::abs(dx), ay = std::abs(dy);
+            if (ax + ay == 1)                     moves.push_back({ dx, dy, five ? 5U : 3U });
+            else if (ax == 1 && ay == 1)          moves.push_back({ dx, dy, five ? 7U : 4U });
+            else if (five && ax * ay == 2)        moves.push_back({ dx, dy, 11U });
+        }
+    }
+    const auto w = static_cast<std::ptrdiff_t>(mask.width), h = static_cast<std::ptrdiff_t>(mask.height);
+    std::vector<std::uint32_t> dist(mask.width * mask.height, std::numeric_limits<std::uint32_t>::max());
+    using item = std::pair<std::uint32_t, std::ptrdiff_t>;
+    std::priority_queue<item, std::vector<item>, std::greater<>> queue;
+    for (std::ptrdiff_t i = 0; i != w * h; ++i) {
+        if (mask.at(i % w, i / w)[0] == 0) queue.emplace(dist[i] = 0, i);
+    }
+    while (!queue.empty()) {
+        const auto [d, i] = queue.top();
+        queue.pop();
+        if (d != dist[i]) continue;
+        for (const auto& m : moves) {
+            const auto x = i % w + m.dx, y = i / w + m.dy;
+            if (x < 0 || y < 0 || x >= w || y >= h || d + m.cost >= dist[y * w + x]) continue;
+            queue.emplace(dist[y * w + x] = d + m.cost, y * w + x);
+        }
+    }
+    std::vector<float64_t> out(dist.size());
+    for (std::size_t i = 0; i != dist.size(); ++i) {
+        out[i] = dist[i] == std::numeric_limits<std::uint32_t>::max() ? std::numeric_limits<float64_t>::infinity() : dist[i] / (five ? 5.0 : 3.0);
+    }
+    return out;
+}
+
+// Float results must match, std::uint16_t results are the rounded values saturated at 65535.
+template <typename Fn>
+void check_distance(const test_image<grey_u8_pixel_t>& mask, const std::vector<float64_t>& ref, Fn transform) {
+    const auto w = mask.width, h = mask.height;
+    std::vector<float32_t>     f((w + 1) * h, -1.F);
+    std::vector<std::uint16_t> u(w * h);
+    transform(mask, matrix_view<float32_t>(f.data(), 0, 0, w, h, static_cast<std::ptrdiff_t>(w + 1)));
+    transform(mask, matrix_view<std::uint16_t>(u.data(), 0, 0, w, h, static_cast<std::ptrdiff_t>(w)));
+    bool float_ok = true, u16_ok = true;
+    for (std::size_t y = 0; y != h; ++y) {
+        for (std::size_t x = 0; x != w; ++x) {
+            const auto r = ref[y * w + x];
+            const auto v = f[y * (w + 1) + x];
+            float_ok &= std::isinf(r) ? std::isinf(v) : std::abs(v - r) <= 1e-5 * (r + 1.0);
+            u16_ok   &= u[y * w + x] == static_cast<std::uint16_t>(std::min(std::floor(r + 0.5), 65535.0));
+        }
+        float_ok &= f[y * (w + 1) + w] == -1.F;
+    }
+    FORCE_CHECK(float_ok);
+    FORCE_CHECK(u16_ok);
+}
+
+void test_distance(const std::size_t w, const std::size_t h, const int density) {
+    const auto mask = random_mask(w, h, density);
+    check_distance(mask, reference_euclidean(mask), [](const auto& m, auto dest) { distance_transform_view(m.view(), dest); });
+    for (const auto kernel : { chamfer_kernel::three_four, chamfer_kernel::five_seven_eleven }) {
+        check_distance(mask, reference_chamfer(mask, kernel), [kernel](const auto& m, auto dest) {
+            chamfer_distance_view(m.view(), dest, kernel);
+        });
+    }
+}
+
+int main() {
+    test_distance(397, 293, 1);
+    test_distance(1500, 40, 3);
+    test_distance(61, 47, 50);
+    test_distance(1, 90, 30);
+    test_distance(90, 1, 30);
+    // No seed at all, every distance is infinite.
+    test_distance(23, 19, 0);
+    // Only one seed in a corner.
+    auto mask = random_mask(120, 80, 0);
+    mask.at(119, 79)[0] = 0;
+    check_distance(mask, reference_euclidean(mask), [](const auto& m, auto dest) { distance_transform_view(m.view(), dest); });
+
+    std::vector<float32_t> small(5 * 5);
+    FORCE_CHECK_THROWS(distance_transform_view(mask.view(), matrix_view<float32_t>(small.data(), 0, 0, 5, 5, 5)));
+    FORCE_CHECK_THROWS(chamfer_distance_view(mask.view(), matrix_view<float32_t>(small.data(), 0, 0, 5, 5, 5)));
+    return force::test::report("image_distance_test");
+}
@@ -0,0 +1,156 @@
+#include "image_test_util.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <deque>
+
+#include "force/media/image_algorithm_edge.hpp"
+
+using namespace force;
+using namespace force::media;
+using force::test::reference_border;
+using force::test::same_image;
+using force::test::test_image;
+
+// gx and gy of every pixel by the full 3x3 kernels, borders clamped.
+struct reference_gradients {
+    std::vector<std::int32_t> gx, gy;
+};
+reference_gradients reference_gradient(const test_image<grey_u8_pixel_t>& src, const gradient_operator op) {
+    const auto w = static_cast<std::ptrdiff_t>(src.width), h = static_cast<std::ptrdiff_t>(src.height);
+    const std::int32_t side = op == gradient_operator::sobel ? 1 : 3, centre = op == gradient_operator::sobel ? 2 : 10;
+    const std::int32_t smooth[3] = { side, centre, side }, diff[3] = { -1, 0, 1 };
+    reference_gradients g{ std::vector<std::int32_t>(src.width * src.height), std::vector<std::int32_t>(src.width * src.height) };
+    for (std::ptrdiff_t y = 0; y != h; ++y) {
+        for (std::ptrdiff_t x = 0; x != w; ++x) {
+            std::int32_t sx = 0, sy = 0;
+            for (std::ptrdiff_t j = -1; j <= 1; ++j) {
+                for (std::ptrdiff_t i = -1; i <= 1; ++i) {
+                    const std::int32_t v = src.at(reference_border(x + i, w, border_policy::clamp), reference_border(y + j, h, border_policy::clamp))[0];
+                    sx += diff[i + 1] * smooth[j + 1] * v;
+                    sy += smooth[i + 1] * diff[j + 1] * v;
+                }
+            }
+            g.gx[y * w + x] = sx;
+            g.gy[y * w + x] = sy;
+        }
+    }
+    return g;
+}
+
+// Canny one step at a time over the whole image: magnitudes, suppression along the gradient sector (same
+// fixed point tangents as the kernel, tan(22.5) = 13573 / 2^15, tan(67.5) = tan(22.5) + 2) and a breadth
+// first flood from every strong pixel.
+test_image<grey_u8_pixel_t> reference_canny(const test_image<grey_u8_pixel_t>& src, const float32_t low, const float32_t high,
+                                            const gradient_operator op, const gradient_norm norm) {
+    const auto w = static_cast<std::ptrdiff_t>(src.width), h = static_cast<std::ptrdiff_t>(src.height);
+    const auto g = reference_gradient(src, op);
+    std::vector<std::int64_t> mag(g.gx.size());
+    for (std::size_t i = 0; i != mag.size(); ++i) {
+        const std::int64_t a = g.gx[i], b = g.gy[i];
+        mag[i] = norm == gradient_norm::l1 ? std::abs(a) + std::abs(b) : a * a + b * b;
+    }
+    auto m_at = [&](std::ptrdiff_t x, std::ptrdiff_t y) { return x < 0 || x >= w || y < 0 || y >= h ? 0 : mag[y * w + x]; };
+    auto level = [norm](const float32_t t) {
+        return static_cast<std::int64_t>(std::floor(norm == gradient_norm::l2 ? static_cast<float64_t>(t) * t : static_cast<float64_t>(t)));
+    };
+    const auto lo = level(low), hi = level(high);
+
+    std::vector<int> cls(mag.size(), 0);
+    for (std::ptrdiff_t y = 0; y != h; ++y) {
+        for (std::ptrdiff_t x = 0; x != w; ++x) {
+            const auto sx = g.gx[y * w + x], sy = g.gy[y * w + x];
+            const std::int64_t ax = std::abs(sx), ay = std::abs(sy);
+            const auto m = m_at(x, y);
+            bool peak;
+            if (ay * 32768 < ax * 13573)                    { peak = m > m_at(x - 1, y) && m >= m_at(x + 1, y); }
+            else if (ay * 32768 > ax * 13573 + ax * 65536) { peak = m > m_at(x, y - 1) && m >= m_at(x, y + 1); }
+            else if ((sx < 0) == (sy < 0))                  { peak = m > m_at(x - 1, y - 1) && m > m_at(x + 1, y + 1); }
+            else                                            { peak = m > m_at(x + 1, y - 1) && m > m_at(x - 1, y + 1); }
+            cls[y * w + x] = !peak || m <= lo ? 0 : m <= hi ? 1 : 2;
+        }
+    }
+    std::deque<std::ptrdiff_t> queue;
+    for (std::size_t i = 0; i != cls.size(); ++i) {
+        if (cls[i] == 2) queue.push_back(static_cast<std::ptrdiff_t>(i));
+    }
+    while (!queue.empty()) {
+        const auto i = queue.front();
+        queue.pop_front();
+        for (std::ptrdiff_t j = -1; j <= 1; ++j) {
+            for (std::ptrdiff_t k = -1; k <= 1; ++k) {
+                const auto x = i % w + k, y = i / w + j;
+                if (x < 0 || x >= w || y < 0 || y >= h || cls[y * w + x] != 1) continue;
+                cls[y * w + x] = 2;
+                queue.push_back(y * w + x);
+            }
+        }
+    }
+    test_image<grey_u8_pixel_t> out(src.width, src.height);
+    for (std::ptrdiff_t y = 0; y != h; ++y) {
+        for (std::ptrdiff_t x = 0; x != w; ++x) { out.at(x, y)[0] = cls[y * w + x] == 2 ? 255 : 0; }
+    }
+    return out;
+}
+
+// Smooth blobs with noise on top: long edges, plenty of weak pixels, and chains that run across band edges.
+test_image<grey_u8_pixel_t> make_image(const std::size_t w, const std::size_t h, const std::size_t pad) {
+    test_image<grey_u8_pixel_t> image(w, h, pad);
+    for (std::size_t y = 0; y != h; ++y) {
+        for (std::size_t x = 0; x != w; ++x) {
+            const auto v = 128.0 + 90.0 * std::sin(static_cast<float64_t>(x) / 13.0) * std::cos(static_cast<float64_t>(y) / 29.0) +
+                           force::test::random_value(-12.0, 12.0);
+            image.at(x, y)[0] = static_cast<std::uint8_t>(std::clamp(v, 0.0, 255.0));
+        }
+    }
+    return image;
+}
+
+void test_gradient() {
+    const auto src = make_image(77, 45, 2);
+    for (const auto op : { gradient_operator::sobel, gradient_operator::scharr }) {
+        const auto ref = reference_gradient(src, op);
+        std::vector<std::int16_t> gx(77 * 45), gy(80 * 45);
+        gradient_view(src.view(), matrix_view<std::int16_t>(gx.data(), 0, 0, 77, 45, 77), matrix_view<std::int16_t>(gy.data(), 0, 0, 77, 45, 80), op);
+        bool same = true;
+        for (std::size_t y = 0; y != 45; ++y) {
+            for (std::size_t x = 0; x != 77; ++x) { same &= gx[y * 77 + x] == ref.gx[y * 77 + x] && gy[y * 80 + x] == ref.gy[y * 77 + x]; }
+        }
+        FORCE_CHECK(same);
+    }
+}
+
+// The image is tall enough to split into many row bands when there are several workers, so edges have
+// to be linked across band edges to match the single pass reference.
+void test_canny() {
+    struct setup {
+        gradient_operator op;
+        gradient_norm     norm;
+        float32_t         low, high;
+    };
+    for (const auto& [w, h, pad] : { std::array<std::size_t, 3>{ 211, 1300, 0 }, { 64, 700, 3 }, { 1, 90, 0 } }) {
+        const auto src = make_image(w, h, pad);
+        for (const auto& s : { setup{ gradient_operator::sobel, gradient_norm::l1, 40.F, 120.F },
+                               setup{ gradient_operator::scharr, gradient_norm::l2, 150.F, 400.F },
+                               setup{ gradient_operator::sobel, gradient_norm::l2, 20.5F, 20.5F } }) {
+            test_image<grey_u8_pixel_t> dest(w, h, 1);
+            canny_view(src.view(), dest.view(), s.low, s.high, s.op, s.norm);
+            FORCE_CHECK(same_image(dest, reference_canny(src, s.low, s.high, s.op, s.norm)));
+        }
+    }
+    // In place.
+    auto image = make_image(90, 400, 0);
+    const auto ref = reference_canny(image, 30.F, 90.F, gradient_operator::sobel, gradient_norm::l1);
+    canny_view(image.view(), image.view(), 30.F, 90.F);
+    FORCE_CHECK(same_image(image, ref));
+}
+
+int main() {
+    test_gradient();
+    test_canny();
+
+    test_image<grey_u8_pixel_t> a(8, 8), b(8, 7);
+    FORCE_CHECK_THROWS(canny_view(a.view(), b.view(), 10.F, 20.F));
+    FORCE_CHECK_THROWS(canny_view(a.view(), a.view(), 30.F, 20.F));
+    return force::test::report("image_edge_test");
+}
@@ -0,0 +1,103 @@
+#include "image_test_util.hpp"
+
+#include <cmath>
+
+#include "force/media/image_algorithm_histogram.hpp"
+
+using namespace force;
+using namespace force::media;
+using force::test::test_image;
+
+// Per-channel histograms of 8bit and 16bit images, flat and padded rows.
+void test_integer_histogram() {
+    for (const std::size_t pad : { 0, 3 }) {
+        test_image<rgb888_u8_pixel_t> image(173, 61, pad);
+        force::test::fill_random(image, 0, 255);
+        const auto h   = histogram_view(image.view());
+        const auto h64 = histogram_view<64>(image.view());
+        image_histogram<3, 256> ref{};
+        image_histogram<3, 64>  ref64{};
+        for (std::size_t y = 0; y != image.height; ++y) {
+            for (std::size_t x = 0; x != image.width; ++x) {
+                for (std::size_t c = 0; c != 3; ++c) {
+                    ++ref[c][image.at(x, y)[c]];
+                    ++ref64[c][image.at(x, y)[c] >> 2];
+                }
+            }
+        }
+        FORCE_CHECK(h == ref);
+        FORCE_CHECK(h64 == ref64);
+    }
+    test_image<media::detail::multichannel_pixel_t<std::uint16_t, 3, 2, 1, 0>> wide(37, 19);
+    force::test::fill_random(wide, 0, 65535);
+    const auto h = histogram_view(wide.view());
+    image_histogram<4, 256> ref{};
+    for (const auto& p : wide.pixels) {
+        for (std::size_t c = 0; c != 4; ++c) { ++ref[c][p[c] >> 8]; }
+    }
+    FORCE_CHECK(h == ref);
+}
+
+// Floating point binning, linear and logarithmic, with out of range values in the end bins.
+void test_float_histogram() {
+    test_image<rgb_f32_pixel_t> image(91, 47, 1);
+    force::test::fill_random(image, -0.5F, 9.F);
+    image.at(0, 0)[0] = NAN;
+    for (const bool logarithmic : { false, true }) {
+        const histogram_binning binning{ .min = logarithmic ? 0.125F : 0.F, .max = 8.F, .bins = 24, .logarithmic = logarithmic };
+        const auto h = histogram_view(image.view(), binning);
+        std::array<std::vector<std::size_t>, 3> ref;
+        for (auto& r : ref) { r.assign(binning.bins, 0); }
+        const auto lo = logarithmic ? std::log2(binning.min) : binning.min;
+        const auto hi = logarithmic ? std::log2(binning.max) : binning.max;
+        for (std::size_t y = 0; y != image.height; ++y) {
+            for (std::size_t x = 0; x != image.width; ++x) {
+                for (std::size_t c = 0; c != 3; ++c) {
+                    auto v = image.at(x, y)[c];
+                    std::size_t b = 0;
+                    if (!std::isnan(v)) {
+                        if (logarithmic) { v = std::log2(std::max(v, binning.min)); }
+                        const auto f = std::floor((v - lo) / (hi - lo) * static_cast<float32_t>(binning.bins));
+                        b = static_cast<std::size_t>(std::clamp(f, 0.F, static_cast<float32_t>(binning.bins - 1)));
+                    }
+                    ++ref[c][b];
+                }
+            }
+        }
+        // Values on a bin edge may fall either way after rounding, compare totals exactly and bins loosely.
+        for (std::size_t c = 0; c != 3; ++c) {
+            std::size_t total = 0, moved = 0;
+            for (std::size_t b = 0; b != binning.bins; ++b) {
+                total += h[c][b];
+                moved += h[c][b] > ref[c][b] ? h[c][b] - ref[c][b] : ref[c][b] - h[c][b];
+            }
+            FORCE_CHECK(total == image.width * image.height);
+            FORCE_CHECK(moved <= 2);
+        }
+    }
+    FORCE_CHECK_THROWS(histogram_view(image.view(), histogram_binning{ .min = 0.F, .max = 1.F, .bins = 0, .logarithmic = false }));
+    FORCE_CHECK_THROWS(histogram_view(image.view(), histogram_binning{ .min = 1.F, .max = 1.F, .bins = 8, .logarithmic = false }));
+    FORCE_CHECK_THROWS(histogram_view(image.view(), histogram_binning{ .min = 0.F, .max = 1.F, .bins = 8, .logarithmic = true }));
+}
+
+// Joint colour histogram against a map of packed keys.
+void test_joint_histogram() {
+    test_image<rgb888_u8_pixel_t> image(211, 97, 2);
+    force::test::fill_random(image, 0, 255);
+    const auto h = joint_histogram_view<5>(image.view());
+    std::vector<std::size_t> ref(std::size_t(1) << 15, 0);
+    for (std::size_t y = 0; y != image.height; ++y) {
+        for (std::size_t x = 0; x != image.width; ++x) {
+            const auto& p = image.at(x, y);
+            ++ref[(std::size_t(p[0] >> 3) << 10) | (std::size_t(p[1] >> 3) << 5) | std::size_t(p[2] >> 3)];
+        }
+    }
+    FORCE_CHECK(h == ref);
+}
+
+int main() {
+    test_integer_histogram();
+    test_float_histogram();
+    test_joint_histogram();
+    return force::test::report("image_histogram_test");
+}
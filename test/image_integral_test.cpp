@@ -0,0 +1,84 @@
+#include "image_test_util.hpp"
+
+#include <cmath>
+
+#include "force/media/image_algorithm_integral.hpp"
+
+using namespace force;
+using namespace force::media;
+using force::test::test_image;
+
+// Every table entry against a direct 2D prefix sum, large enough to run on several bands and strips.
+template <typename Pix, typename Ty>
+void test_integral_table(const std::size_t w, const std::size_t h, const std::size_t pad, const Ty lo, const Ty hi) {
+    constexpr auto channels = media::detail::pixel_channels_v<Pix>;
+    test_image<Pix> image(w, h, pad);
+    force::test::fill_random(image, lo, hi);
+    const auto sum     = integral_view(image.view());
+    const auto squared = squared_integral_view(image.view());
+    using acc_t = typename decltype(sum)::value_type;
+    using sq_t  = typename decltype(squared)::value_type;
+
+    bool table_ok = sum.width() == w && sum.height() == h;
+    std::vector<acc_t> above((w + 1) * channels, acc_t(0));
+    std::vector<sq_t>  above_sq((w + 1) * channels, sq_t(0));
+    for (std::size_t c = 0; c != channels; ++c) { table_ok &= sum.at(0, 0, c) == acc_t(0) && sum.at(w, 0, c) == acc_t(0); }
+    for (std::size_t y = 1; y <= h; ++y) {
+        std::vector<acc_t> run(channels, acc_t(0));
+        std::vector<sq_t>  run_sq(channels, sq_t(0));
+        for (std::size_t x = 1; x <= w; ++x) {
+            for (std::size_t c = 0; c != channels; ++c) {
+                const auto v = image.at(x - 1, y - 1)[c];
+                run[c]    += static_cast<acc_t>(v);
+                run_sq[c] += static_cast<sq_t>(v) * static_cast<sq_t>(v);
+                above[x * channels + c]    += run[c];
+                above_sq[x * channels + c] += run_sq[c];
+                if constexpr (std::is_floating_point_v<acc_t>) {
+                    table_ok &= std::abs(sum.at(x, y, c) - above[x * channels + c]) <= 1e-9 * std::abs(above[x * channels + c]) + 1e-9;
+                }
+                else {
+                    table_ok &= sum.at(x, y, c) == above[x * channels + c] && squared.at(x, y, c) == above_sq[x * channels + c];
+                }
+            }
+        }
+    }
+    FORCE_CHECK(table_ok);
+
+    // Random rectangles against direct sums.
+    bool rect_ok = true;
+    for (int i = 0; i != 50; ++i) {
+        const auto x  = force::test::random_value<std::size_t>(0, w - 1);
+        const auto y  = force::test::random_value<std::size_t>(0, h - 1);
+        const auto rw = force::test::random_value<std::size_t>(1, w - x);
+        const auto rh = force::test::random_value<std::size_t>(1, h - y);
+        const auto c  = force::test::random_value<std::size_t>(0, channels - 1);
+        float64_t direct = 0.0, direct_sq = 0.0;
+        for (auto j = y; j != y + rh; ++j) {
+            for (auto k = x; k != x + rw; ++k) {
+                const auto v = static_cast<float64_t>(image.at(k, j)[c]);
+                direct    += v;
+                direct_sq += v * v;
+            }
+        }
+        rect_ok &= std::abs(static_cast<float64_t>(sum.rect_sum(x, y, rw, rh, c)) - direct) <= 1e-6 * (std::abs(direct) + 1.0);
+        const auto n    = static_cast<float64_t>(rw * rh);
+        const auto mean = direct / n;
+        const auto [m, var] = integral_rect_statistics(sum, squared, x, y, rw, rh, c);
+        rect_ok &= std::abs(m - mean) <= 1e-6 * (std::abs(mean) + 1.0);
+        rect_ok &= std::abs(var - std::max(0.0, direct_sq / n - mean * mean)) <= 1e-6 * (direct_sq / n + 1.0);
+    }
+    FORCE_CHECK(rect_ok);
+}
+
+int main() {
+    test_integral_table<rgb888_u8_pixel_t>(397, 311, 0, 0, 255);
+    test_integral_table<rgba8888_u8_pixel_t>(129, 67, 5, 0, 255);
+    test_integral_table<grey_u8_pixel_t>(1, 40, 0, 0, 255);
+    test_integral_table<media::detail::multichannel_pixel_t<std::uint16_t, 0>>(301, 233, 2, 0, 65535);
+    test_integral_table<rgb_f32_pixel_t>(93, 71, 1, -1.F, 1.F);
+    // Empty views give an all zero 1 x 1 table.
+    test_image<grey_u8_pixel_t> empty(0, 0);
+    const auto table = integral_view(empty.view());
+    FORCE_CHECK(table.width() == 0 && table.height() == 0 && table.at(0, 0, 0) == 0);
+    return force::test::report("image_integral_test");
+}
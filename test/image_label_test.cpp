@@ -0,0 +1,113 @@
+#include "image_test_util.hpp"
+
+#include <cmath>
+
+#include "force/media/image_algorithm_label.hpp"
+
+using namespace force;
+using namespace force::media;
+using force::test::test_image;
+
+// Flood fill labeling. Components are numbered in raster order of their first pixel, with 8-connectivity
+// of their first 2x2 block, the order label_components_view documents.
+std::vector<std::uint32_t> reference_labels(const test_image<grey_u8_pixel_t>& mask, const connectivity conn, std::vector<component_stats>& stats) {
+    const auto w = static_cast<std::ptrdiff_t>(mask.width), h = static_cast<std::ptrdiff_t>(mask.height);
+    std::vector<std::uint32_t> fill(mask.width * mask.height, 0);
+    std::vector<std::size_t>   first;
+    std::vector<std::ptrdiff_t> stack;
+    std::uint32_t n = 0;
+    for (std::ptrdiff_t y = 0; y != h; ++y) {
+        for (std::ptrdiff_t x = 0; x != w; ++x) {
+            if (mask.at(x, y)[0] == 0 || fill[y * w + x] != 0) continue;
+            fill[y * w + x] = ++n;
+            first.push_back(std::numeric_limits<std::size_t>::max());
+            stack.assign(1, y * w + x);
+            while (!stack.empty()) {
+                const auto i = stack.back(), px = i % w, py = i / w;
+                stack.pop_back();
+                const auto key = conn == connectivity::eight ? static_cast<std::size_t>((py / 2) * w + px / 2) : static_cast<std::size_t>(i);
+                first.back() = std::min(first.back(), key);
+                for (std::ptrdiff_t dy = -1; dy <= 1; ++dy) {
+                    for (std::ptrdiff_t dx = -1; dx <= 1; ++dx) {
+                        if ((dx == 0 && dy == 0) || (conn == connectivity::four && dx != 0 && dy != 0)) continue;
+                        const auto qx = px + dx, qy = py + dy;
+                        if (qx < 0 || qy < 0 || qx >= w || qy >= h || mask.at(qx, qy)[0] == 0 || fill[qy * w + qx] != 0) continue;
+                        fill[qy * w + qx] = n;
+                        stack.push_back(qy * w + qx);
+                    }
+                }
+            }
+        }
+    }
+    // Renumber by first pixel (block) and gather statistics.
+    std::vector<std::uint32_t> order(n), rank(n + 1, 0);
+    for (std::uint32_t i = 0; i != n; ++i) { order[i] = i; }
+    std::sort(order.begin(), order.end(), [&](const auto a, const auto b) { return first[a] < first[b]; });
+    for (std::uint32_t i = 0; i != n; ++i) { rank[order[i] + 1] = i + 1; }
+    stats.assign(n, component_stats{});
+    std::vector<float64_t> sx(n, 0.0), sy(n, 0.0);
+    for (std::ptrdiff_t y = 0; y != h; ++y) {
+        for (std::ptrdiff_t x = 0; x != w; ++x) {
+            auto& l = fill[y * w + x];
+            if (l == 0) continue;
+            l = rank[l];
+            auto& s = stats[l - 1];
+            if (s.area == 0) { s.left = s.right = static_cast<std::size_t>(x); s.top = s.bottom = static_cast<std::size_t>(y); }
+            ++s.area;
+            s.left   = std::min(s.left, static_cast<std::size_t>(x));
+            s.right  = std::max(s.right, static_cast<std::size_t>(x));
+            s.top    = std::min(s.top, static_cast<std::size_t>(y));
+            s.bottom = std::max(s.bottom, static_cast<std::size_t>(y));
+            sx[l - 1] += static_cast<float64_t>(x);
+            sy[l - 1] += static_cast<float64_t>(y);
+        }
+    }
+    for (std::uint32_t i = 0; i != n; ++i) {
+        stats[i].centroid_x = sx[i] / static_cast<float64_t>(stats[i].area);
+        stats[i].centroid_y = sy[i] / static_cast<float64_t>(stats[i].area);
+    }
+    return fill;
+}
+
+// Random masks around the percolation threshold give long winding components that cross strips.
+void test_labels(const std::size_t w, const std::size_t h, const int density) {
+    test_image<grey_u8_pixel_t> mask(w, h, 3);
+    for (auto& p : mask.pixels) { p[0] = force::test::random_value(0, 99) < density ? static_cast<std::uint8_t>(force::test::random_value(1, 255)) : 0; }
+    for (const auto conn : { connectivity::four, connectivity::eight }) {
+        std::vector<component_stats> ref_stats;
+        const auto ref = reference_labels(mask, conn, ref_stats);
+        // Label map with padded rows, the padding must stay untouched.
+        std::vector<std::uint32_t> ids((w + 2) * h, 0xDEADBEEF);
+        const auto stats = label_components_view(mask.view(), matrix_view<std::uint32_t>(ids.data(), 0, 0, w, h, static_cast<std::ptrdiff_t>(w + 2)), conn);
+        bool labels_ok = true, padding_ok = true;
+        for (std::size_t y = 0; y != h; ++y) {
+            for (std::size_t x = 0; x != w; ++x) { labels_ok &= ids[y * (w + 2) + x] == ref[y * w + x]; }
+            padding_ok &= ids[y * (w + 2) + w] == 0xDEADBEEF && ids[y * (w + 2) + w + 1] == 0xDEADBEEF;
+        }
+        FORCE_CHECK(labels_ok);
+        FORCE_CHECK(padding_ok);
+        bool stats_ok = stats.size() == ref_stats.size();
+        for (std::size_t i = 0; stats_ok && i != stats.size(); ++i) {
+            const auto& a = stats[i];
+            const auto& b = ref_stats[i];
+            stats_ok &= a.area == b.area && a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+            stats_ok &= std::abs(a.centroid_x - b.centroid_x) < 1e-9 && std::abs(a.centroid_y - b.centroid_y) < 1e-9;
+        }
+        FORCE_CHECK(stats_ok);
+    }
+}
+
+int main() {
+    test_labels(613, 401, 50);
+    test_labels(613, 401, 59);
+    test_labels(97, 131, 30);
+    test_labels(1, 300, 70);
+    test_labels(300, 1, 70);
+    test_labels(33, 17, 100);
+    test_labels(33, 17, 0);
+
+    test_image<grey_u8_pixel_t> mask(8, 8);
+    std::vector<std::uint32_t> ids(8 * 7);
+    FORCE_CHECK_THROWS(label_components_view(mask.view(), matrix_view<std::uint32_t>(ids.data(), 0, 0, 8, 7, 8)));
+    return force::test::report("image_label_test");
+}
@@ -0,0 +1,67 @@
+#include "image_test_util.hpp"
+
+#include "force/media/image_algorithm_median.hpp"
+
+using namespace force;
+using namespace force::media;
+using force::test::test_image;
+using force::test::reference_border;
+using force::test::same_image;
+
+// Sorts every window.
+template <typename Pix>
+test_image<Pix> reference_median(const test_image<Pix>& src, const std::size_t radius, const border_policy border) {
+    constexpr auto channels = media::detail::pixel_channels_v<Pix>;
+    const auto w = static_cast<std::ptrdiff_t>(src.width), h = static_cast<std::ptrdiff_t>(src.height), r = static_cast<std::ptrdiff_t>(radius);
+    test_image<Pix> out(src.width, src.height);
+    std::vector<std::uint8_t> window;
+    for (std::ptrdiff_t y = 0; y != h; ++y) {
+        for (std::ptrdiff_t x = 0; x != w; ++x) {
+            for (std::size_t c = 0; c != channels; ++c) {
+                window.clear();
+                for (auto j = y - r; j <= y + r; ++j) {
+                    for (auto i = x - r; i <= x + r; ++i) { window.push_back(src.at(reference_border(i, w, border), reference_border(j, h, border))[c]); }
+                }
+                std::nth_element(window.begin(), window.begin() + window.size() / 2, window.end());
+                out.at(x, y)[c] = window[window.size() / 2];
+            }
+        }
+    }
+    return out;
+}
+
+constexpr border_policy borders[] = { border_policy::clamp, border_policy::mirror, border_policy::wrap };
+
+// Sorting networks (r = 1, 2) and the histogram method (r > 2) under every border.
+template <typename Pix>
+void test_median(const std::size_t w, const std::size_t h, const std::initializer_list<std::size_t> radii) {
+    test_image<Pix> src(w, h, 2);
+    force::test::fill_random(src, 0, 255);
+    for (const auto border : borders) {
+        for (const auto r : radii) {
+            test_image<Pix> dest(w, h, 1);
+            median_filter_view(src.view(), dest.view(), r, border);
+            FORCE_CHECK(same_image(dest, reference_median(src, r, border)));
+        }
+    }
+}
+
+int main() {
+    test_median<rgb888_u8_pixel_t>(131, 77, { 0, 1, 2, 3, 7 });
+    test_median<grey_u8_pixel_t>(37, 5, { 1, 2, 4, 20 });
+    test_median<rgba8888_u8_pixel_t>(300, 9, { 1, 2, 18 });
+    // Window far wider than the image, the histograms look past the buffer's border.
+    test_median<rgb888_u8_pixel_t>(6, 4, { 13, 300 });
+
+    // In place, and a few values only (ties everywhere).
+    test_image<grey_u8_pixel_t> image(64, 48);
+    force::test::fill_random(image, 0, 3);
+    const auto ref = reference_median(image, 5, border_policy::mirror);
+    median_filter_view(image.view(), image.view(), 5, border_policy::mirror);
+    FORCE_CHECK(same_image(image, ref));
+
+    test_image<grey_u8_pixel_t> small(63, 48);
+    FORCE_CHECK_THROWS(median_filter_view(image.view(), small.view(), 1));
+    FORCE_CHECK_THROWS(median_filter_view(image.view(), image.view(), 40000));
+    return force::test::report("image_median_test");
+}
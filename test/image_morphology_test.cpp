@@ -0,0 +1,95 @@
+#include "image_test_util.hpp"
+
+#include "force/media/image_algorithm_morphology.hpp"
+
+using namespace force;
+using namespace force::media;
+using force::test::test_image;
+using force::test::same_image;
+
+// Minimum (or maximum) over the kw x kh rectangle whose anchor (ax, ay) is on the pixel, pixels outside are skipped.
+template <typename Pix>
+test_image<Pix> reference_rank(const test_image<Pix>& src, const std::size_t kw, const std::size_t kh, const std::size_t ax, const std::size_t ay,
+                               const bool maximum) {
+    constexpr auto channels = media::detail::pixel_channels_v<Pix>;
+    const auto w = static_cast<std::ptrdiff_t>(src.width), h = static_cast<std::ptrdiff_t>(src.height);
+    test_image<Pix> out(src.width, src.height);
+    for (std::ptrdiff_t y = 0; y != h; ++y) {
+        for (std::ptrdiff_t x = 0; x != w; ++x) {
+            for (std::size_t c = 0; c != channels; ++c) {
+                bool first = true;
+                typename Pix::value_type best{};
+                for (auto j = y - static_cast<std::ptrdiff_t>(ay); j != y - static_cast<std::ptrdiff_t>(ay) + static_cast<std::ptrdiff_t>(kh); ++j) {
+                    for (auto i = x - static_cast<std::ptrdiff_t>(ax); i != x - static_cast<std::ptrdiff_t>(ax) + static_cast<std::ptrdiff_t>(kw); ++i) {
+                        if (i < 0 || j < 0 || i >= w || j >= h) continue;
+                        const auto v = src.at(i, j)[c];
+                        if (first || (maximum ? v > best : v < best)) { best = v; }
+                        first = false;
+                    }
+                }
+                out.at(x, y)[c] = best;
+            }
+        }
+    }
+    return out;
+}
+
+template <typename Pix, typename Ty>
+void test_morphology(const std::size_t w, const std::size_t h, const Ty lo, const Ty hi) {
+    test_image<Pix> src(w, h, 3);
+    force::test::fill_random(src, lo, hi);
+    constexpr std::size_t kernels[][2] = { { 1, 1 }, { 3, 3 }, { 4, 2 }, { 1, 7 }, { 8, 1 }, { 5, 6 }, { 64, 3 } };
+    for (const auto& k : kernels) {
+        const auto kw = k[0], kh = k[1];
+        const auto ax = kw / 2, ay = kh / 2, rx = kw - 1 - kw / 2, ry = kh - 1 - kh / 2;
+        const auto eroded  = reference_rank(src, kw, kh, ax, ay, false);
+        const auto dilated = reference_rank(src, kw, kh, ax, ay, true);
+        const auto opened  = reference_rank(eroded, kw, kh, rx, ry, true);
+        const auto closed  = reference_rank(dilated, kw, kh, rx, ry, false);
+        test_image<Pix> top(w, h), black(w, h);
+        for (std::size_t y = 0; y != h; ++y) {
+            for (std::size_t x = 0; x != w; ++x) {
+                for (std::size_t c = 0; c != media::detail::pixel_channels_v<Pix>; ++c) {
+                    top.at(x, y)[c]   = static_cast<typename Pix::value_type>(src.at(x, y)[c] - opened.at(x, y)[c]);
+                    black.at(x, y)[c] = static_cast<typename Pix::value_type>(closed.at(x, y)[c] - src.at(x, y)[c]);
+                }
+            }
+        }
+        test_image<Pix> dest(w, h, 1);
+        erode_view(src.view(), dest.view(), kw, kh);
+        FORCE_CHECK(same_image(dest, eroded));
+        dilate_view(src.view(), dest.view(), kw, kh);
+        FORCE_CHECK(same_image(dest, dilated));
+        open_view(src.view(), dest.view(), kw, kh);
+        FORCE_CHECK(same_image(dest, opened));
+        close_view(src.view(), dest.view(), kw, kh);
+        FORCE_CHECK(same_image(dest, closed));
+        top_hat_view(src.view(), dest.view(), kw, kh);
+        FORCE_CHECK(same_image(dest, top));
+        black_hat_view(src.view(), dest.view(), kw, kh);
+        FORCE_CHECK(same_image(dest, black));
+    }
+    // In place.
+    const auto eroded = reference_rank(src, 5, 3, 2, 1, false);
+    erode_view(src.view(), src.view(), 5, 3);
+    FORCE_CHECK(same_image(src, eroded));
+}
+
+// dest must have the size of src.
+void test_size_mismatch() {
+    test_image<grey_u8_pixel_t> src(16, 16), dest(32, 32);
+    FORCE_CHECK_THROWS(erode_view(src.view(), dest.view(), 3, 3));
+    FORCE_CHECK_THROWS(dilate_view(src.view(), dest.view(), 3, 3));
+    FORCE_CHECK_THROWS(open_view(src.view(), dest.view(), 3, 3));
+    FORCE_CHECK_THROWS(close_view(dest.view(), src.view(), 3, 3));
+    FORCE_CHECK_THROWS(top_hat_view(src.view(), dest.view(), 3, 3));
+    FORCE_CHECK_THROWS(black_hat_view(src.view(), dest.view(), 3, 3));
+}
+
+int main() {
+    test_morphology<rgb888_u8_pixel_t>(301, 173, 0, 255);
+    test_morphology<grey_u8_pixel_t>(37, 5, 0, 255);
+    test_morphology<rgba_f32_pixel_t>(45, 39, -10.F, 10.F);
+    test_size_mismatch();
+    return force::test::report("image_morphology_test");
+}
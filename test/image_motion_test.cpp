@@ -0,0 +1,99 @@
+#include "image_test_util.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+
+#include "force/media/image_algorithm_motion.hpp"
+
+using namespace force;
+using namespace force::media;
+using force::test::test_image;
+
+// SAD of the n x n block of cur at (x, y) against prev displaced by (dx, dy), the largest value when that
+// block isn't inside prev.
+std::uint32_t reference_sad(const test_image<grey_u8_pixel_t>& prev, const test_image<grey_u8_pixel_t>& cur, const std::ptrdiff_t x,
+                            const std::ptrdiff_t y, const std::ptrdiff_t dx, const std::ptrdiff_t dy, const std::ptrdiff_t n) {
+    if (x + dx < 0 || y + dy < 0 || x + dx + n > static_cast<std::ptrdiff_t>(prev.width) || y + dy + n > static_cast<std::ptrdiff_t>(prev.height)) {
+        return std::numeric_limits<std::uint32_t>::max();
+    }
+    std::uint32_t s = 0;
+    for (std::ptrdiff_t j = 0; j != n; ++j) {
+        for (std::ptrdiff_t i = 0; i != n; ++i) { s += static_cast<std::uint32_t>(std::abs(cur.at(x + i, y + j)[0] - prev.at(x + dx + i, y + dy + j)[0])); }
+    }
+    return s;
+}
+
+// prev and cur cut from one noise texture, cur shifted by (sx, sy): block (x, y) of cur is prev at (x + sx, y + sy).
+struct shifted_frames {
+    test_image<grey_u8_pixel_t> prev, cur;
+};
+shifted_frames make_frames(const std::size_t w, const std::size_t h, const std::ptrdiff_t sx, const std::ptrdiff_t sy) {
+    constexpr std::ptrdiff_t margin = 32;
+    test_image<grey_u8_pixel_t> texture(w + 2 * margin, h + 2 * margin);
+    force::test::fill_random(texture, 0, 255);
+    shifted_frames f{ test_image<grey_u8_pixel_t>(w, h, 3), test_image<grey_u8_pixel_t>(w, h) };
+    for (std::ptrdiff_t y = 0; y != static_cast<std::ptrdiff_t>(h); ++y) {
+        for (std::ptrdiff_t x = 0; x != static_cast<std::ptrdiff_t>(w); ++x) {
+            f.prev.at(x, y) = texture.at(x + margin, y + margin);
+            f.cur.at(x, y)  = texture.at(x + margin + sx, y + margin + sy);
+        }
+    }
+    return f;
+}
+
+// Full search over noise finds the shift exactly wherever the shifted block lies inside prev. Every block,
+// those at the edges too, gets a vector whose SAD is the smallest within the range.
+void test_global_shift() {
+    for (const std::size_t block : { 8, 16 }) {
+        for (const auto& [sx, sy] : { std::array<std::ptrdiff_t, 2>{ 5, -3 }, { -7, 7 }, { 0, 0 } }) {
+            const auto f = make_frames(203, 141, sx, sy);
+            const motion_options opt{ .block = block, .range = 7, .search = motion_search::full };
+            const auto fw = motion_field_width(203, opt), fh = motion_field_height(141, opt);
+            std::vector<motion_vector> mv(fw * fh);
+            estimate_motion_view(f.prev.view(), f.cur.view(), matrix_view<motion_vector>(mv.data(), 0, 0, fw, fh, static_cast<std::ptrdiff_t>(fw)), opt);
+            bool shift = true, minimal = true;
+            const auto n = static_cast<std::ptrdiff_t>(block);
+            for (std::size_t by = 0; by != fh; ++by) {
+                for (std::size_t bx = 0; bx != fw; ++bx) {
+                    const auto& v = mv[by * fw + bx];
+                    const auto  x = static_cast<std::ptrdiff_t>(bx) * n, y = static_cast<std::ptrdiff_t>(by) * n;
+                    if (reference_sad(f.prev, f.cur, x, y, sx, sy, n) == 0) { shift &= v.x == sx && v.y == sy && v.sad == 0; }
+                    std::uint32_t best = std::numeric_limits<std::uint32_t>::max();
+                    for (std::ptrdiff_t dy = -opt.range; dy <= opt.range; ++dy) {
+                        for (std::ptrdiff_t dx = -opt.range; dx <= opt.range; ++dx) { best = std::min(best, reference_sad(f.prev, f.cur, x, y, dx, dy, n)); }
+                    }
+                    minimal &= v.sad == best && reference_sad(f.prev, f.cur, x, y, v.x, v.y, n) == best;
+                }
+            }
+            FORCE_CHECK(shift);
+            FORCE_CHECK(minimal);
+        }
+    }
+}
+
+// A range of 0 allows no motion: every vector is zero, whatever the search and the pyramid depth.
+void test_zero_range() {
+    const auto f = make_frames(160, 128, 4, 2);
+    for (const auto search : { motion_search::full, motion_search::diamond, motion_search::hexagon }) {
+        for (const std::size_t levels : { 1, 3 }) {
+            const motion_options opt{ .block = 16, .range = 0, .search = search, .levels = levels };
+            std::vector<motion_vector> mv(10 * 8, motion_vector{ 1, 1, 0 });
+            estimate_motion_view(f.prev.view(), f.cur.view(), matrix_view<motion_vector>(mv.data(), 0, 0, 10, 8, 10), opt);
+            FORCE_CHECK(std::ranges::all_of(mv, [](const motion_vector& v) { return v.x == 0 && v.y == 0; }));
+        }
+    }
+}
+
+int main() {
+    test_global_shift();
+    test_zero_range();
+
+    test_image<grey_u8_pixel_t> a(64, 64), b(64, 48);
+    std::vector<motion_vector> mv(16);
+    FORCE_CHECK_THROWS(estimate_motion_view(a.view(), b.view(), matrix_view<motion_vector>(mv.data(), 0, 0, 4, 4, 4)));
+    FORCE_CHECK_THROWS(estimate_motion_view(a.view(), a.view(), matrix_view<motion_vector>(mv.data(), 0, 0, 4, 3, 4)));
+    FORCE_CHECK_THROWS(estimate_motion_view(a.view(), a.view(), matrix_view<motion_vector>(mv.data(), 0, 0, 4, 4, 4), motion_options{ .range = -1 }));
+    return force::test::report("image_motion_test");
+}
@@ -0,0 +1,113 @@
+#include "image_test_util.hpp"
+
+#include "force/media/image_algorithm_quantize.hpp"
+
+using namespace force;
+using namespace force::media;
+using force::test::test_image;
+
+// Serial Floyd-Steinberg with the same 1/16 fixed point errors, one row after the other.
+test_image<grey_u8_pixel_t> reference_floyd_steinberg(const test_image<rgb888_u8_pixel_t>& src, const image_palette<rgb888_u8_pixel_t>& palette,
+                                                      const inverse_palette<rgb888_u8_pixel_t>& inverse, const bool serpentine) {
+    const auto w = static_cast<std::ptrdiff_t>(src.width);
+    test_image<grey_u8_pixel_t> out(src.width, src.height);
+    std::vector<std::int32_t> cur((w + 2) * 3, 0), next((w + 2) * 3, 0);
+    for (std::size_t y = 0; y != src.height; ++y) {
+        std::ranges::fill(next, 0);
+        const bool           backward = serpentine && (y & 1);
+        const std::ptrdiff_t dir      = backward ? -1 : 1;
+        std::int32_t carry[3] = {};
+        for (std::ptrdiff_t i = 0; i != w; ++i) {
+            const auto x = backward ? w - 1 - i : i;
+            std::int32_t c[3];
+            for (std::size_t ch = 0; ch != 3; ++ch) {
+                const auto e = cur[(x + 1) * 3 + ch] + carry[ch];
+                c[ch] = std::clamp<std::int32_t>(src.at(x, y)[ch] + ((e + 8) >> 4), 0, 255);
+            }
+            const auto index = inverse(c[0], c[1], c[2]);
+            out.at(x, y)[0] = index;
+            for (std::size_t ch = 0; ch != 3; ++ch) {
+                const auto e = c[ch] - static_cast<std::int32_t>(palette[index][ch]);
+                carry[ch] = 7 * e;
+                next[(x + 1 - dir) * 3 + ch] += 3 * e;
+                next[(x + 1) * 3 + ch]       += 5 * e;
+                next[(x + 1 + dir) * 3 + ch] += e;
+            }
+        }
+        std::swap(cur, next);
+    }
+    return out;
+}
+
+// Smooth gradients with some noise, so errors keep travelling right and down.
+test_image<rgb888_u8_pixel_t> make_image(const std::size_t w, const std::size_t h, const std::size_t pad) {
+    test_image<rgb888_u8_pixel_t> image(w, h, pad);
+    for (std::size_t y = 0; y != h; ++y) {
+        for (std::size_t x = 0; x != w; ++x) {
+            auto& p = image.at(x, y);
+            p[0] = static_cast<std::uint8_t>(x * 255 / w);
+            p[1] = static_cast<std::uint8_t>(y * 255 / h);
+            p[2] = static_cast<std::uint8_t>(std::clamp(128 + force::test::random_value(-40, 40), 0, 255));
+        }
+    }
+    return image;
+}
+
+// The raster wavefront must reproduce the serial scan exactly, on an image tall enough for every thread.
+void test_floyd_steinberg() {
+    for (const auto& [w, h, pad] : { std::array<std::size_t, 3>{ 301, 517, 0 }, { 1000, 64, 3 }, { 5, 200, 1 }, { 130, 1, 0 } }) {
+        const auto src     = make_image(w, h, pad);
+        const auto palette = median_cut_palette(src.view(), 16);
+        const inverse_palette<rgb888_u8_pixel_t> inverse(palette);
+        for (const auto scan : { error_diffusion_scan::raster, error_diffusion_scan::serpentine }) {
+            test_image<grey_u8_pixel_t> dest(w, h, 2);
+            dither_floyd_steinberg_view(src.view(), palette, inverse, dest.view(), scan);
+            FORCE_CHECK(force::test::same_image(dest, reference_floyd_steinberg(src, palette, inverse, scan == error_diffusion_scan::serpentine)));
+        }
+    }
+}
+
+// remap_view looks every pixel up in the inverse palette, whose cells hold the nearest entry to their centre.
+void test_remap() {
+    const auto src     = make_image(97, 61, 1);
+    const auto palette = octree_palette(src.view(), 24);
+    const inverse_palette<rgb888_u8_pixel_t> inverse(palette);
+    test_image<grey_u8_pixel_t> dest(97, 61);
+    remap_view(src.view(), inverse, dest.view());
+    bool ok = palette.size() <= 24;
+    for (std::size_t y = 0; y != src.height; ++y) {
+        for (std::size_t x = 0; x != src.width; ++x) {
+            std::int32_t c[3], best = std::numeric_limits<std::int32_t>::max();
+            for (std::size_t ch = 0; ch != 3; ++ch) { c[ch] = (src.at(x, y)[ch] & ~7) + 4; }
+            for (const auto& p : palette) {
+                std::int32_t d = 0;
+                for (std::size_t ch = 0; ch != 3; ++ch) { d += (c[ch] - p[ch]) * (c[ch] - p[ch]); }
+                best = std::min(best, d);
+            }
+            const auto& p = palette[dest.at(x, y)[0]];
+            std::int32_t d = 0;
+            for (std::size_t ch = 0; ch != 3; ++ch) { d += (c[ch] - p[ch]) * (c[ch] - p[ch]); }
+            ok &= d == best;
+        }
+    }
+    FORCE_CHECK(ok);
+}
+
+void test_errors() {
+    const auto src = make_image(16, 16, 0);
+    FORCE_CHECK_THROWS(inverse_palette<rgb888_u8_pixel_t>(image_palette<rgb888_u8_pixel_t>{}));
+    FORCE_CHECK_THROWS(inverse_palette<rgb888_u8_pixel_t>(image_palette<rgb888_u8_pixel_t>(257)));
+    const image_palette<rgb888_u8_pixel_t> palette(2);
+    const inverse_palette<rgb888_u8_pixel_t> inverse(palette);
+    test_image<grey_u8_pixel_t> dest(32, 32);
+    FORCE_CHECK_THROWS(remap_view(src.view(), inverse, dest.view()));
+    FORCE_CHECK_THROWS(dither_ordered_view(src.view(), inverse, dest.view()));
+    FORCE_CHECK_THROWS(dither_floyd_steinberg_view(src.view(), palette, inverse, dest.view()));
+}
+
+int main() {
+    test_floyd_steinberg();
+    test_remap();
+    test_errors();
+    return force::test::report("image_quantize_test");
+}
@@ -0,0 +1,168 @@
+#include "image_test_util.hpp"
+
+#include <cmath>
+#include <numbers>
+
+#include "force/media/image_algorithm_resample.hpp"
+
+using namespace force;
+using namespace force::media;
+using force::test::test_image;
+
+constexpr resample_filter filters[] = { resample_filter::box, resample_filter::bilinear, resample_filter::bicubic, resample_filter::lanczos3 };
+
+float64_t reference_kernel(const resample_filter filter, const float64_t x) {
+    const auto a = std::abs(x);
+    switch (filter) {
+    case resample_filter::box:      return a < 0.5 ? 1.0 : a == 0.5 ? 0.5 : 0.0;
+    case resample_filter::bilinear: return std::max(0.0, 1.0 - a);
+    case resample_filter::bicubic:  return a < 1.0 ? 1.5 * a * a * a - 2.5 * a * a + 1.0 : a < 2.0 ? -0.5 * a * a * a + 2.5 * a * a - 4.0 * a + 2.0 : 0.0;
+    case resample_filter::lanczos3: {
+        if (a == 0.0) return 1.0;
+        if (a >= 3.0) return 0.0;
+        const auto p = std::numbers::pi * a;
+        return 3.0 * std::sin(p) * std::sin(p / 3.0) / (p * p);
+    }
+    }
+    return 0.0;
+}
+float64_t reference_radius(const resample_filter filter) {
+    return filter == resample_filter::box ? 0.5 : filter == resample_filter::bilinear ? 1.0 : filter == resample_filter::bicubic ? 2.0 : 3.0;
+}
+
+// Normalized weights of every source pixel for destination i: source pixels whose centres lie within the
+// (widened when downscaling) support, the nearest one if there are none.
+std::vector<std::vector<float64_t>> reference_weights(const std::size_t src, const std::size_t dst, const resample_filter filter) {
+    const auto scale   = static_cast<float64_t>(src) / static_cast<float64_t>(dst);
+    const auto stretch = std::max(scale, 1.0);
+    const auto support = reference_radius(filter) * stretch;
+    std::vector<std::vector<float64_t>> weights(dst, std::vector<float64_t>(src, 0.0));
+    for (std::size_t i = 0; i != dst; ++i) {
+        const auto centre = (static_cast<float64_t>(i) + 0.5) * scale;
+        float64_t  sum    = 0.0;
+        for (std::size_t j = 0; j != src; ++j) {
+            const auto d = static_cast<float64_t>(j) + 0.5 - centre;
+            if (d <= -support || d > support) continue;
+            sum += weights[i][j] = reference_kernel(filter, d / stretch);
+        }
+        if (sum == 0.0) { weights[i][std::min(static_cast<std::size_t>(centre), src - 1)] = sum = 1.0; }
+        for (auto& v : weights[i]) { v /= sum; }
+    }
+    return weights;
+}
+
+// Resampled channel values in float64, decode maps the stored values first.
+template <typename Pix, typename Fn>
+std::vector<float64_t> reference_resample(const test_image<Pix>& src, const std::size_t dw, const std::size_t dh, const resample_filter filter, Fn decode) {
+    constexpr auto channels = media::detail::pixel_channels_v<Pix>;
+    const auto hw = reference_weights(src.width, dw, filter);
+    const auto vw = reference_weights(src.height, dh, filter);
+    std::vector<float64_t> middle(src.height * dw * channels, 0.0), out(dh * dw * channels, 0.0);
+    for (std::size_t y = 0; y != src.height; ++y) {
+        for (std::size_t x = 0; x != dw; ++x) {
+            for (std::size_t j = 0; j != src.width; ++j) {
+                if (hw[x][j] == 0.0) continue;
+                for (std::size_t c = 0; c != channels; ++c) { middle[(y * dw + x) * channels + c] += hw[x][j] * decode(src.at(j, y)[c], c); }
+            }
+        }
+    }
+    for (std::size_t y = 0; y != dh; ++y) {
+        for (std::size_t j = 0; j != src.height; ++j) {
+            if (vw[y][j] == 0.0) continue;
+            for (std::size_t i = 0; i != dw * channels; ++i) { out[y * dw * channels + i] += vw[y][j] * middle[j * dw * channels + i]; }
+        }
+    }
+    return out;
+}
+
+// Largest difference between dest and the reference after encode.
+template <typename Pix, typename Fn>
+float64_t max_difference(const test_image<Pix>& dest, const std::vector<float64_t>& ref, Fn encode) {
+    constexpr auto channels = media::detail::pixel_channels_v<Pix>;
+    float64_t d = 0.0;
+    for (std::size_t y = 0; y != dest.height; ++y) {
+        for (std::size_t x = 0; x != dest.width; ++x) {
+            for (std::size_t c = 0; c != channels; ++c) {
+                const auto r = encode(ref[(y * dest.width + x) * channels + c], c);
+                d = std::max(d, std::abs(static_cast<float64_t>(dest.at(x, y)[c]) - r));
+            }
+        }
+    }
+    return d;
+}
+
+constexpr std::size_t sizes[][4] = { { 31, 29, 97, 83 }, { 64, 48, 150, 48 }, { 150, 120, 37, 41 }, { 90, 60, 30, 20 }, { 7, 5, 3, 11 } };
+
+// Float pixels are exact up to float rounding, 8bit within one level even on hard edges where bicubic
+// and Lanczos overshoot, 16bit within the Q14 weight rounding.
+void test_direct() {
+    auto identity = [](const auto v, std::size_t) { return static_cast<float64_t>(v); };
+    for (const auto filter : filters) {
+        for (const auto& s : sizes) {
+            test_image<rgb_f32_pixel_t> f(s[0], s[1], 1);
+            force::test::fill_random(f, -1.F, 1.F);
+            test_image<rgb_f32_pixel_t> fd(s[2], s[3]);
+            resample_view(f.view(), fd.view(), filter);
+            FORCE_CHECK(max_difference(fd, reference_resample(f, s[2], s[3], filter, identity), identity) < 1e-4);
+
+            // Black and white noise, the worst case for overshoot.
+            test_image<rgba8888_u8_pixel_t> b(s[0], s[1], 2);
+            for (auto& p : b.pixels) {
+                for (std::size_t c = 0; c != 4; ++c) { p[c] = force::test::random_value(0, 1) * 255; }
+            }
+            test_image<rgba8888_u8_pixel_t> bd(s[2], s[3], 3);
+            resample_view(b.view(), bd.view(), filter);
+            FORCE_CHECK(max_difference(bd, reference_resample(b, s[2], s[3], filter, identity), [](const float64_t v, std::size_t) {
+                return std::round(std::clamp(v, 0.0, 255.0));
+            }) <= 1.0);
+
+            test_image<media::detail::multichannel_pixel_t<std::uint16_t, 2, 1, 0>> w(s[0], s[1]);
+            force::test::fill_random(w, 0, 65535);
+            test_image<media::detail::multichannel_pixel_t<std::uint16_t, 2, 1, 0>> wd(s[2], s[3]);
+            resample_view(w.view(), wd.view(), filter);
+            FORCE_CHECK(max_difference(wd, reference_resample(w, s[2], s[3], filter, identity), [](const float64_t v, std::size_t) {
+                return std::round(std::clamp(v, 0.0, 65535.0));
+            }) <= 16.0);
+        }
+    }
+    // Same size bilinear is a copy.
+    test_image<rgb888_u8_pixel_t> src(23, 17), dest(23, 17, 1);
+    force::test::fill_random(src, 0, 255);
+    resample_view(src.view(), dest.view());
+    bool same = true;
+    for (std::size_t y = 0; y != src.height; ++y) {
+        for (std::size_t x = 0; x != src.width; ++x) {
+            for (std::size_t c = 0; c != 3; ++c) { same &= src.at(x, y)[c] == dest.at(x, y)[c]; }
+        }
+    }
+    FORCE_CHECK(same);
+}
+
+// sRGB colour channels are averaged as linear light, alpha (channel 3) as stored.
+void test_srgb() {
+    auto decode = [](const std::uint8_t v, const std::size_t c) {
+        const auto s = v / 255.0;
+        if (c == 3) return s;
+        return s <= 0.04045 ? s / 12.92 : std::pow((s + 0.055) / 1.055, 2.4);
+    };
+    auto encode = [](float64_t v, const std::size_t c) {
+        v = std::clamp(v, 0.0, 1.0);
+        if (c != 3) { v = v <= 0.0031308 ? v * 12.92 : 1.055 * std::pow(v, 1.0 / 2.4) - 0.055; }
+        return std::round(v * 255.0);
+    };
+    for (const auto filter : filters) {
+        for (const auto& s : sizes) {
+            test_image<rgba8888_u8_pixel_t> src(s[0], s[1], 1);
+            force::test::fill_random(src, 0, 255);
+            test_image<rgba8888_u8_pixel_t> dest(s[2], s[3]);
+            resample_view<srgb_transfer>(src.view(), dest.view(), filter, 3);
+            FORCE_CHECK(max_difference(dest, reference_resample(src, s[2], s[3], filter, decode), encode) <= 1.0);
+        }
+    }
+}
+
+int main() {
+    test_direct();
+    test_srgb();
+    return force::test::report("image_resample_test");
+}
@@ -0,0 +1,129 @@
+#include "image_test_util.hpp"
+
+#include <cstdint>
+#include <limits>
+
+#include "force/vector.hpp"
+#include "force/media/pixels.hpp"
+
+using namespace force;
+using namespace force::media;
+
+// The operations in 64bit arithmetic, clamped.
+template <typename Ty>
+struct reference {
+    static constexpr std::int64_t lo = std::numeric_limits<Ty>::min(), hi = std::numeric_limits<Ty>::max();
+    static Ty clamp(const std::int64_t v) { return static_cast<Ty>(std::min(std::max(v, lo), hi)); }
+    static Ty adds(const Ty a, const Ty b)  { return clamp(std::int64_t(a) + b); }
+    static Ty subs(const Ty a, const Ty b)  { return clamp(std::int64_t(a) - b); }
+    // Rounded up, floor division for negative sums.
+    static Ty avg(const Ty a, const Ty b)   { const auto s = std::int64_t(a) + b + 1; return static_cast<Ty>(s >= 0 ? s / 2 : (s - 1) / 2); }
+    static Ty mulhi(const Ty a, const Ty b) {
+        const auto p = std::int64_t(a) * b, d = std::int64_t(1) << (8 * sizeof(Ty));
+        return static_cast<Ty>(p >= 0 ? p / d : -((-p + d - 1) / d));
+    }
+    static std::make_unsigned_t<Ty> absdiff(const Ty a, const Ty b) { return static_cast<std::make_unsigned_t<Ty>>(a > b ? std::int64_t(a) - b : std::int64_t(b) - a); }
+};
+
+template <typename Ty>
+bool check_pair(const Ty a, const Ty b) {
+    using ref = reference<Ty>;
+    return adds(a, b) == ref::adds(a, b) && subs(a, b) == ref::subs(a, b) && avg(a, b) == ref::avg(a, b) &&
+           mulhi(a, b) == ref::mulhi(a, b) && absdiff(a, b) == ref::absdiff(a, b);
+}
+
+// Every pair of 8bit values, the corners and random pairs of 16bit values.
+template <typename Ty>
+void test_scalar() {
+    bool ok = true;
+    constexpr std::int64_t lo = std::numeric_limits<Ty>::min(), hi = std::numeric_limits<Ty>::max();
+    if constexpr (sizeof(Ty) == 1) {
+        for (auto a = lo; a <= hi; ++a) {
+            for (auto b = lo; b <= hi; ++b) { ok &= check_pair(static_cast<Ty>(a), static_cast<Ty>(b)); }
+        }
+    }
+    else {
+        const std::int64_t corners[] = { lo, lo + 1, lo / 2, -1, 0, 1, hi / 2, hi - 1, hi };
+        for (const auto a : corners) {
+            for (const auto b : corners) {
+                if (a >= lo && b >= lo) ok &= check_pair(static_cast<Ty>(a), static_cast<Ty>(b));
+            }
+        }
+        for (int i = 0; i != 1 << 20; ++i) {
+            const auto a = force::test::random_value<Ty>(static_cast<Ty>(lo), static_cast<Ty>(hi));
+            const auto b = force::test::random_value<Ty>(static_cast<Ty>(lo), static_cast<Ty>(hi));
+            ok &= check_pair(a, b);
+        }
+    }
+    FORCE_CHECK(ok);
+}
+
+void test_saturate_cast() {
+    FORCE_CHECK(saturate_cast<std::uint8_t>(-5) == 0);
+    FORCE_CHECK(saturate_cast<std::uint8_t>(300) == 255);
+    FORCE_CHECK(saturate_cast<std::uint8_t>(77) == 77);
+    FORCE_CHECK(saturate_cast<std::int8_t>(200U) == 127);
+    FORCE_CHECK(saturate_cast<std::int16_t>(-70000) == -32768);
+    FORCE_CHECK(saturate_cast<std::uint16_t>(std::uint64_t(1) << 40) == 65535);
+    FORCE_CHECK(saturate_cast<std::uint32_t>(-1) == 0);
+    static_assert(adds<std::uint8_t>(200, 100) == 255 && subs<std::int8_t>(-100, 100) == -128 && avg<std::uint16_t>(65535, 65535) == 65535);
+}
+
+// Vector overloads apply the scalar operation lane by lane.
+template <typename Ty>
+void test_vector() {
+    constexpr std::size_t n = 16;
+    bool ok = true;
+    for (int i = 0; i != 1000; ++i) {
+        vector<Ty, n> a, b;
+        for (std::size_t k = 0; k != n; ++k) {
+            a[k] = force::test::random_value(std::numeric_limits<Ty>::min(), std::numeric_limits<Ty>::max());
+            b[k] = force::test::random_value(std::numeric_limits<Ty>::min(), std::numeric_limits<Ty>::max());
+        }
+        const auto s = adds(a, b), d = subs(a, b), m = avg(a, b), h = mulhi(a, b);
+        const auto x = absdiff(a, b);
+        const auto w = widen(a);
+        const auto c = saturate_cast<std::uint8_t>(w);
+        for (std::size_t k = 0; k != n; ++k) {
+            using ref = reference<Ty>;
+            ok &= s[k] == ref::adds(a[k], b[k]) && d[k] == ref::subs(a[k], b[k]) && m[k] == ref::avg(a[k], b[k]) && h[k] == ref::mulhi(a[k], b[k]);
+            ok &= x[k] == ref::absdiff(a[k], b[k]) && w[k] == a[k] && c[k] == reference<std::uint8_t>::clamp(a[k]);
+        }
+    }
+    FORCE_CHECK(ok);
+}
+
+// Pixel overloads keep every channel in its place.
+void test_pixel() {
+    bool ok = true;
+    for (int i = 0; i != 1000; ++i) {
+        rgba8888_u8_pixel_t a, b;
+        for (std::size_t c = 0; c != 4; ++c) {
+            a[c] = force::test::random_value<std::uint8_t>(0, 255);
+            b[c] = force::test::random_value<std::uint8_t>(0, 255);
+        }
+        const auto s = adds(a, b), d = subs(a, b), m = avg(a, b), h = mulhi(a, b), x = absdiff(a, b);
+        const auto w = widen(a);
+        const auto n = saturate_cast<std::uint8_t>(w);
+        for (std::size_t c = 0; c != 4; ++c) {
+            using ref = reference<std::uint8_t>;
+            ok &= s[c] == ref::adds(a[c], b[c]) && d[c] == ref::subs(a[c], b[c]) && m[c] == ref::avg(a[c], b[c]) && h[c] == ref::mulhi(a[c], b[c]);
+            ok &= x[c] == ref::absdiff(a[c], b[c]) && w[c] == a[c] && n[c] == a[c];
+        }
+    }
+    FORCE_CHECK(ok);
+}
+
+int main() {
+    test_scalar<std::uint8_t>();
+    test_scalar<std::int8_t>();
+    test_scalar<std::uint16_t>();
+    test_scalar<std::int16_t>();
+    test_saturate_cast();
+    test_vector<std::uint8_t>();
+    test_vector<std::int8_t>();
+    test_vector<std::uint16_t>();
+    test_vector<std::int16_t>();
+    test_pixel();
+    return force::test::report("image_saturate_test");
+}
@@ -0,0 +1,118 @@
+///
+/// \file      image_test_util.hpp
+/// \brief     Shared helpers of the image algorithm tests.
+/// \details
+///
+/// Every test program checks a kernel against a naive reference written next to it, counts the failed
+/// checks and returns non zero if there were any, so ctest can run them directly. Images are kept in
+/// test_image, which can pad its rows so the strided (non flat) code paths are covered as well. Pieces
+/// several references share (border handling, exact comparison) live here.
+///
+/// \author    HenryDu
+/// \date      18.10.2026
+/// \copyright © HenryDu 2026. All right reserved.
+///
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "force/matrix_view.hpp"
+#include "force/media/pixels.hpp"
+#include "force/media/image_view.hpp"
+
+namespace force::test {
+    inline int failures = 0;
+
+    inline void check(const bool ok, const char* what, const int line) {
+        if (!ok) {
+            std::fprintf(stderr, "line %d: check failed: %s\n", line, what);
+            ++failures;
+        }
+    }
+#define FORCE_CHECK(...) ::force::test::check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __LINE__)
+
+    // Checks that f throws std::runtime_error.
+    template <typename Fn>
+    void check_throws(Fn&& f, const char* what, const int line) {
+        bool thrown = false;
+        try { f(); }
+        catch (const std::runtime_error&) { thrown = true; }
+        check(thrown, what, line);
+    }
+#define FORCE_CHECK_THROWS(...) ::force::test::check_throws([&] { __VA_ARGS__; }, #__VA_ARGS__, __LINE__)
+
+    // Returns the process exit code.
+    inline int report(const char* name) {
+        if (failures == 0) std::printf("%s: passed\n", name);
+        else               std::printf("%s: %d checks failed\n", name, failures);
+        return failures == 0 ? 0 : 1;
+    }
+
+    // Width x height image, rows are padded by pad pixels.
+    template <typename Pix>
+    struct test_image {
+        std::size_t      width  = 0;
+        std::size_t      height = 0;
+        std::size_t      stride = 0;
+        std::vector<Pix> pixels;
+
+        test_image(const std::size_t w, const std::size_t h, const std::size_t pad = 0)
+            : width(w), height(h), stride(w + pad), pixels(stride * h) {}
+
+        Pix&       at(const std::size_t x, const std::size_t y)       { return pixels[y * stride + x]; }
+        const Pix& at(const std::size_t x, const std::size_t y) const { return pixels[y * stride + x]; }
+        matrix_view<Pix> view() const { return matrix_view<Pix>(pixels.data(), 0, 0, width, height, static_cast<std::ptrdiff_t>(stride)); }
+    };
+
+    // Source coordinate of i in an image of n pixels, by plain stepping so it doesn't share code with the
+    // kernels. Border is border_policy, a template so that tests without borders don't need its header.
+    template <typename Border>
+    std::ptrdiff_t reference_border(std::ptrdiff_t i, const std::ptrdiff_t n, const Border border) {
+        while (i < 0 || i >= n) {
+            switch (border) {
+            case Border::clamp:  i = i < 0 ? 0 : n - 1; break;
+            case Border::wrap:   i = i < 0 ? i + n : i - n; break;
+            case Border::mirror: i = n == 1 ? 0 : i < 0 ? -i : 2 * (n - 1) - i; break;
+            }
+        }
+        return i;
+    }
+
+    // Every channel of every pixel equal, padding is ignored.
+    template <typename Pix>
+    bool same_image(const test_image<Pix>& a, const test_image<Pix>& b) {
+        if (a.width != b.width || a.height != b.height) return false;
+        for (std::size_t y = 0; y != a.height; ++y) {
+            for (std::size_t x = 0; x != a.width; ++x) {
+                for (std::size_t c = 0; c != media::detail::pixel_channels_v<Pix>; ++c) {
+                    if (a.at(x, y)[c] != b.at(x, y)[c]) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    inline std::mt19937& random_engine() {
+        static std::mt19937 engine(20261018);
+        return engine;
+    }
+    // Uniform value in [lo, hi].
+    template <typename Ty>
+    Ty random_value(const Ty lo, const Ty hi) {
+        if constexpr (std::is_floating_point_v<Ty>) { return std::uniform_real_distribution<Ty>(lo, hi)(random_engine()); }
+        else { return static_cast<Ty>(std::uniform_int_distribution<long long>(lo, hi)(random_engine())); }
+    }
+    // Every channel of every pixel uniform in [lo, hi].
+    template <typename Pix, typename Ty>
+    void fill_random(test_image<Pix>& image, const Ty lo, const Ty hi) {
+        for (auto& p : image.pixels) {
+            for (std::size_t c = 0; c != media::detail::pixel_channels_v<Pix>; ++c) { p[c] = static_cast<typename Pix::value_type>(random_value(lo, hi)); }
+        }
+    }
+}
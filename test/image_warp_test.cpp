@@ -0,0 +1,93 @@
+#include "image_test_util.hpp"
+
+#include <array>
+#include <cmath>
+
+#include "force/media/image_algorithm_warp.hpp"
+
+using namespace force;
+using namespace force::media;
+using force::test::test_image;
+
+// Source coordinates of destination pixel (dx, dy) under the source -> destination map h (row major 3x3):
+// h * (x, y, 1) is proportional to (dx, dy, 1), solved for x and y with Cramer's rule.
+std::array<float64_t, 2> reference_source(const std::array<float64_t, 9>& h, const float64_t dx, const float64_t dy) {
+    const auto a = h[0] - dx * h[6], b = h[1] - dx * h[7], e = dx * h[8] - h[2];
+    const auto c = h[3] - dy * h[6], d = h[4] - dy * h[7], f = dy * h[8] - h[5];
+    const auto det = a * d - b * c;
+    return { (e * d - b * f) / det, (a * f - e * c) / det };
+}
+
+// Largest channel difference between dest and a pixel by pixel inverse mapping of src. Taps outside src read
+// fill. Nearest pixels whose coordinates sit on a rounding tie could go either way and are skipped.
+template <typename SrcPix, typename DstPix>
+float64_t warp_difference(const test_image<SrcPix>& src, const test_image<DstPix>& dest, const std::array<float64_t, 9>& h,
+                          const warp_filter filter, const DstPix& fill) {
+    constexpr auto channels = media::detail::pixel_channels_v<DstPix>;
+    const auto w = static_cast<std::ptrdiff_t>(src.width), hh = static_cast<std::ptrdiff_t>(src.height);
+    auto tap = [&](const std::ptrdiff_t x, const std::ptrdiff_t y, const std::size_t c) {
+        return x >= 0 && x < w && y >= 0 && y < hh ? static_cast<float64_t>(src.at(x, y)[c]) : static_cast<float64_t>(fill[c]);
+    };
+    float64_t diff = 0.0;
+    for (std::size_t y = 0; y != dest.height; ++y) {
+        for (std::size_t x = 0; x != dest.width; ++x) {
+            const auto [sx, sy] = reference_source(h, static_cast<float64_t>(x), static_cast<float64_t>(y));
+            for (std::size_t c = 0; c != channels; ++c) {
+                float64_t r;
+                if (filter == warp_filter::nearest) {
+                    auto tie = [](const float64_t v) { return std::abs(v + 0.5 - std::round(v + 0.5)) < 1e-6; };
+                    if (tie(sx) || tie(sy)) continue;
+                    r = tap(static_cast<std::ptrdiff_t>(std::floor(sx + 0.5)), static_cast<std::ptrdiff_t>(std::floor(sy + 0.5)), c);
+                }
+                else {
+                    const auto ix = static_cast<std::ptrdiff_t>(std::floor(sx)), iy = static_cast<std::ptrdiff_t>(std::floor(sy));
+                    const auto fx = sx - static_cast<float64_t>(ix), fy = sy - static_cast<float64_t>(iy);
+                    const auto top    = tap(ix, iy, c) * (1.0 - fx) + tap(ix + 1, iy, c) * fx;
+                    const auto bottom = tap(ix, iy + 1, c) * (1.0 - fx) + tap(ix + 1, iy + 1, c) * fx;
+                    r = top * (1.0 - fy) + bottom * fy;
+                }
+                diff = std::max(diff, std::abs(static_cast<float64_t>(dest.at(x, y)[c]) - r));
+            }
+        }
+    }
+    return diff;
+}
+
+// Rotation with scale about the centre, part of the destination falls outside the source.
+const matrix<float32_t, 2, 3> affine(0.95F, -0.55F, 40.F, 0.5F, 1.05F, -20.F);
+// Mild perspective, the third coordinate stays positive over the whole destination.
+const matrix<float32_t, 3, 3> perspective(1.1F, 0.2F, -5.F, -0.1F, 0.9F, 8.F, 0.0008F, -0.0005F, 1.F);
+
+std::array<float64_t, 9> full(const matrix<float32_t, 2, 3>& m) { return { m[0], m[1], m[2], m[3], m[4], m[5], 0.0, 0.0, 1.0 }; }
+std::array<float64_t, 9> full(const matrix<float32_t, 3, 3>& m) { return { m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8] }; }
+
+// Nearest is exact. Bilinear is within float rounding for float pixels and within the 8 bit weights for 8bit ones.
+template <typename SrcPix, typename DstPix, typename Ty>
+void test_warp(const std::size_t sw, const std::size_t sh, const std::size_t dw, const std::size_t dh, const std::size_t pad,
+               const Ty lo, const Ty hi, const float64_t tolerance) {
+    test_image<SrcPix> src(sw, sh, pad);
+    force::test::fill_random(src, lo, hi);
+    DstPix fill;
+    for (std::size_t c = 0; c != media::detail::pixel_channels_v<DstPix>; ++c) { fill[c] = static_cast<typename DstPix::value_type>(hi); }
+    for (const auto filter : { warp_filter::nearest, warp_filter::bilinear }) {
+        const auto limit = filter == warp_filter::nearest ? 0.0 : tolerance;
+        test_image<DstPix> a(dw, dh, pad);
+        warp_affine_view(src.view(), a.view(), affine, filter, fill);
+        FORCE_CHECK(warp_difference(src, a, full(affine), filter, fill) <= limit);
+        test_image<DstPix> p(dw, dh, pad);
+        warp_perspective_view(src.view(), p.view(), perspective, filter, fill);
+        FORCE_CHECK(warp_difference(src, p, full(perspective), filter, fill) <= limit);
+    }
+}
+
+int main() {
+    test_warp<rgb888_u8_pixel_t, rgb888_u8_pixel_t>(97, 61, 120, 90, 0, 0, 255, 2.0);
+    test_warp<rgba8888_u8_pixel_t, rgba8888_u8_pixel_t>(130, 70, 256, 160, 3, 0, 255, 2.0);
+    test_warp<bgr888_u8_pixel_t, rgb888_u8_pixel_t>(40, 33, 64, 50, 1, 0, 255, 2.0);
+    test_warp<rgb_f32_pixel_t, rgb_f32_pixel_t>(97, 61, 256, 160, 2, -1.F, 1.F, 1e-4);
+    test_warp<grey_u8_pixel_t, grey_u8_pixel_t>(1, 1, 9, 7, 0, 0, 255, 2.0);
+
+    test_image<rgb888_u8_pixel_t> src(8, 8), dest(8, 8);
+    FORCE_CHECK_THROWS(warp_affine_view(src.view(), dest.view(), matrix<float32_t, 2, 3>(1.F, 2.F, 0.F, 2.F, 4.F, 0.F)));
+    return force::test::report("image_warp_test");
+}
@@ -0,0 +1,92 @@
+#include "image_test_util.hpp"
+
+#include <array>
+#include <vector>
+
+#include "force/matrix_layout.hpp"
+
+using namespace force;
+
+constexpr std::array<std::array<std::size_t, 2>, 9> sizes{ { { 1, 1 }, { 7, 5 }, { 13, 37 }, { 100, 3 }, { 3, 100 }, { 33, 64 }, { 64, 64 }, { 65, 17 }, { 129, 130 } } };
+
+// Row-major w x h grid with padded rows, element (x, y) holds y * w + x + 1 so nothing equals the zeroed storage.
+struct grid {
+    std::size_t      width, height, stride;
+    std::vector<int> data;
+
+    grid(const std::size_t w, const std::size_t h) : width(w), height(h), stride(w + 3), data(stride * h, 0) {}
+    matrix_view<int> view() { return matrix_view<int>(data.data(), 0, 0, width, height, static_cast<std::ptrdiff_t>(stride)); }
+    int&             at(const std::size_t x, const std::size_t y) { return data[y * stride + x]; }
+    static int       value(const std::size_t w, const std::size_t x, const std::size_t y) { return static_cast<int>(y * w + x + 1); }
+};
+
+// Converting in and back out gives the source again, every element sits at index(x, y), and for_each_view and
+// copy_view see every element exactly once, in storage order, with its own coordinates.
+template <typename Layout>
+void check_layout(grid& src, Layout layout) {
+    const auto w = src.width, h = src.height;
+    copy_view_layout(src.view(), layout);
+    bool placed = true;
+    for (std::size_t y = 0; y != h; ++y) {
+        for (std::size_t x = 0; x != w; ++x) { placed &= layout.index(x, y) < layout.storage_size() && layout.data()[layout.index(x, y)] == src.at(x, y); }
+    }
+    FORCE_CHECK(placed);
+
+    grid back(w, h);
+    copy_view_layout(layout, back.view());
+    bool same = true;
+    for (std::size_t y = 0; y != h; ++y) {
+        for (std::size_t x = 0; x != w; ++x) { same &= back.at(x, y) == src.at(x, y); }
+    }
+    FORCE_CHECK(same);
+
+    std::vector<int> seen(w * h, 0), order;
+    std::ptrdiff_t   last  = -1;
+    bool             right = true, ascending = true;
+    for_each_view(layout, [&](int& v, const std::size_t x, const std::size_t y) {
+        right &= x < w && y < h && v == grid::value(w, x, y);
+        if (x < w && y < h) ++seen[y * w + x];
+        const auto offset = &v - layout.data();
+        ascending &= offset > last;
+        last = offset;
+        order.push_back(v);
+    });
+    FORCE_CHECK(right);
+    FORCE_CHECK(ascending);
+    FORCE_CHECK(std::ranges::all_of(seen, [](const int n) { return n == 1; }));
+
+    std::size_t count = 0;
+    for_each_view(layout, [&count](int&) { ++count; });
+    FORCE_CHECK(count == w * h);
+
+    std::vector<int> copied(w * h, 0);
+    FORCE_CHECK(copy_view(layout, copied.begin()) == copied.end());
+    FORCE_CHECK(copied == order);
+}
+
+void test_layouts() {
+    for (const auto& [w, h] : sizes) {
+        grid src(w, h);
+        for (std::size_t y = 0; y != h; ++y) {
+            for (std::size_t x = 0; x != w; ++x) { src.at(x, y) = grid::value(w, x, y); }
+        }
+        for (const auto& [tw, th] : { std::array<std::size_t, 2>{ 1, 1 }, { 4, 8 }, { 16, 4 }, { 32, 32 } }) {
+            std::vector<int> storage(tiled_matrix_view<int>::storage_size(w, h, tw, th), 0);
+            check_layout(src, tiled_matrix_view<int>(storage.data(), w, h, tw, th));
+        }
+        std::vector<int> storage(morton_matrix_view<int>::storage_size(w, h), 0);
+        const morton_matrix_view<int> morton(storage.data(), w, h);
+        // The last element is the largest index, so the buffer is exactly as large as it needs to be.
+        FORCE_CHECK(morton.index(w - 1, h - 1) + 1 == morton.storage_size());
+        check_layout(src, morton);
+    }
+}
+
+int main() {
+    test_layouts();
+
+    std::vector<int> storage(64);
+    FORCE_CHECK_THROWS(tiled_matrix_view<int>(storage.data(), 8, 8, 3, 4));
+    FORCE_CHECK_THROWS(tiled_matrix_view<int>(storage.data(), 8, 8, 4, 0));
+    return force::test::report("matrix_layout_test");
+}